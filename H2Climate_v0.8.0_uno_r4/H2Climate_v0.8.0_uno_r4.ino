@@ -7,15 +7,27 @@
  */
 
 #include "src/network/NetworkManager.h"
+#include "src/network/UpdateScheduler.h"
 #include "src/sensors/SensorManager.h"
+#include "src/sensors/Dht22Driver.h"
+#include "src/sensors/Sht3xDriver.h"
+#include "src/sensors/Scd4xDriver.h"
+#include "src/sensors/SoundLevelDriver.h"
+#include "src/sensors/TraceReplayDriver.h"
+#include "src/sensors/traces/SyntheticOfficeTrace.h"
+#include "src/sensors/ReadingFilter.h"
+#include "src/sensors/DerivedChannels.h"
+#include "src/sensors/OccupancyDetector.h"
+#include "src/sensors/WindowAggregator.h"
+#include "src/sensors/DeadbandReporter.h"
+#include "src/sensors/AlertEngine.h"
 #include "src/utils/BatteryMonitor.h"
+#include "src/utils/PowerManager.h"
+#include "src/utils/DutyCyclePolicy.h"
 
 //¤=======================================================================================¤
 //| TODO: Update TDOD list                                                                |
-//| TODO: Add sound sensor (Sound sensor is garbango so maybe not)                        |
 //| TODO: Changeable settings                                                             |
-//| TODO: Add warning triggers at certain temperatures and humidities                     |
-//| TODO: Store more sensor data before sending a packet to reduce packet spam            |
 //¤=======================================================================================¤
 
 // Global objects
@@ -23,20 +35,42 @@ FancyLog fancyLog;
 OTAManager otaManager;
 DisplayManager display;
 NetworkManager network(fancyLog, otaManager, display);
+FirmwareSeeder seeder(fancyLog);
+UpdateScheduler updateScheduler;
 SensorManager sensors(fancyLog);
+Dht22Driver dht22(DHT22_PIN);
+Sht3xDriver sht3x(SHT3X_I2C_ADDRESS);
+Scd4xDriver scd4x(SCD4X_I2C_ADDRESS);
+SoundLevelDriver soundLevel(SOUND_PIN);
+TraceReplayDriver traceReplay(SYNTHETIC_OFFICE_TRACE);
+ReadingFilter readingFilter;
+OccupancyDetector occupancy;
+WindowAggregator aggregator;
+DeadbandReporter reporter;
+AlertEngine alerts;
 BatteryMonitor battery(fancyLog);
+PowerManager power;
+DutyCyclePolicy dutyPolicy;
 DeviceIdentifier deviceID;
 
 // Timing variables
 unsigned long previousMillis = 0;
-unsigned long previousUpdateCheckMillis = 0;
 unsigned long previousBatteryLogMillis = 0;
+unsigned long previousFilterLogMillis = 0;
+unsigned long worstFilterMicros = 0; // Since the last filter cost line
+
+// Staged boot state, subsystems start in setup() and become ready in loop()
+bool samplingStarted = false;
+bool deviceRegistered = false;
+unsigned long firstReadingMillis = 0; // Time to first reading after boot, 0 until it happened
+unsigned long firstUploadMillis = 0; // Time to first successful upload after boot
+bool bootMetricsReported = false;
 
 // Data collection variables
 int dataCount = 0;
 struct SensorData {
-  	float temperature;
-  	float humidity;
+  	float values[SENSOR_CHANNEL_COUNT];
+  	uint16_t channelMask; // Bit per SensorChannel present in values
   	float batteryVoltage;
   	int batteryPercentage;
   	int batteryTimeRemaining;
@@ -44,6 +78,19 @@ struct SensorData {
 };
 SensorData dataBuffer[DATA_BUFFER_SIZE]; // Using DATA_BUFFER_SIZE defined in Config.h
 
+// Upload documents sized for the worst case. postUpload() adds rejected, health, power, drain rate,
+// OTA report, policy and boot members, and copies the OTA strings and the device ID into the document
+const size_t UPLOAD_EXTRAS_CAPACITY = JSON_OBJECT_SIZE(7) + JSON_OBJECT_SIZE(SENSOR_CHANNEL_COUNT) +
+                                      JSON_OBJECT_SIZE(MAX_SENSOR_DRIVERS) + MAX_SENSOR_DRIVERS * JSON_OBJECT_SIZE(7) +
+                                      JSON_OBJECT_SIZE(3) + JSON_OBJECT_SIZE(10) + JSON_OBJECT_SIZE(7) + JSON_OBJECT_SIZE(2) + 192;
+const size_t RAW_UPLOAD_CAPACITY = JSON_OBJECT_SIZE(SENSOR_CHANNEL_COUNT + 5) + UPLOAD_EXTRAS_CAPACITY;
+const size_t SUMMARY_UPLOAD_CAPACITY = JSON_OBJECT_SIZE(SENSOR_CHANNEL_COUNT + 8) + SENSOR_CHANNEL_COUNT * JSON_OBJECT_SIZE(5) +
+                                       JSON_OBJECT_SIZE(5) + UPLOAD_EXTRAS_CAPACITY;
+bool uploadRawSamples = UPLOAD_RAW_SAMPLES; // Summaries are always sent, raw samples only on demand
+uint16_t unsentAlerts = 0; // Bit per alert rule whose last state change has not reached the server yet
+unsigned long alertRetryMillis[MAX_ALERT_RULES]; // Last failed attempt per rule
+unsigned long alertRetryDelay[MAX_ALERT_RULES]; // Backoff before the next attempt, 0 sends right away
+
 
 void clearEEPROM() {
     for (int i = 0; i < EEPROM.length(); i++) {
@@ -68,33 +115,45 @@ void setup() {
 	// Calling getDeviceId also initialize the DeviceIdentifier
     fancyLog.toSerial("Starting H2Climate Device | ID: " + String(deviceID.getDeviceId()), INFO);
 
+  	// Optional button that opens the IDE OTA listener
+  	if (OTA_BUTTON_PIN >= 0) {
+    	pinMode(OTA_BUTTON_PIN, INPUT_PULLUP);
+  	}
+
   	// Initialize LED matrix
   	display.begin();
   	display.showNeutralFace();  // Show neutral face during setup
 
-  	// Initialize sensors
+  	// Register sensor drivers, the precise SHT3x overrides the DHT22 channels when fitted
+  	if (ENABLE_TRACE_REPLAY) {
+    	sensors.addDriver(traceReplay); // Stands in for all real sensors
+  	} else {
+    	sensors.addDriver(dht22);
+    	if (ENABLE_SHT3X) {
+      		sensors.addDriver(sht3x);
+    	}
+    	if (ENABLE_SCD4X) {
+      		sensors.addDriver(scd4x);
+    	}
+    	if (ENABLE_SOUND_SENSOR) {
+      		sensors.addDriver(soundLevel);
+    	}
+  	}
+
+  	// Start every subsystem without waiting for it, sensor warm-up and WiFi association overlap
   	fancyLog.toSerial("Initializing sensors", INFO);
   	sensors.begin();
   
-  	// Initialize battery monitoring
   	fancyLog.toSerial("Initializing battery monitoring", INFO);
   	battery.begin();
 
-  	// Connect to network after sensors are initialized
   	network.begin();
 
-  	// Register device with server
-  	StaticJsonDocument<256> jsonDoc;
-  	jsonDoc["deviceId"] = DeviceIdentifier::getDeviceId();
-  	jsonDoc["modelType"] = MODEL_TYPE;
-  	jsonDoc["firmwareVersion"] = FIRMWARE_VERSION;
-
-  	String registerData;
-  	serializeJson(jsonDoc, registerData);
-  	network.sendHttpPostRequest(registerData, API_REGISTER_ROUTE);
+  	// Registration and seeding follow in loop() once WiFi is up
 
-  	// Initial update check
-  	network.checkForUpdates();
+  	// Schedule the first update check, offset per device so a fleet reboot does not align
+  	updateScheduler.begin(DeviceIdentifier::getDeviceId(), millis());
+  	fancyLog.toSerial("First update check in " + String(updateScheduler.getMillisUntilDue(millis()) / 1000) + "s", INFO);
   	fancyLog.toSerial("Setup complete", INFO);
 }
 
@@ -102,22 +161,65 @@ void setup() {
 //| Runtime loop |
 //¤==============¤========================================================================¤
 void loop() {
-  	// Handle OTA updates
+  	// Requests for the IDE OTA listener come from the serial console or the button
+  	handleSerialCommands();
+  	if (OTA_BUTTON_PIN >= 0 && digitalRead(OTA_BUTTON_PIN) == LOW && !network.isOTAWindowOpen()) {
+    	network.openOTAWindow();
+  	}
+
+  	// Handle OTA updates, only costs time while the listener window is open
   	network.pollOTA();
 
+  	// Filter the finished microphone block, the next one fills in the background
+  	if (ENABLE_SOUND_SENSOR && !ENABLE_TRACE_REPLAY) {
+    	soundLevel.process();
+  	}
+
+  	// Move a pending firmware download forward without blocking the sampling schedule
+  	network.pollUpdate();
+
+  	// Serve firmware chunks to peers
+  	seeder.poll();
+
   	unsigned long currentMillis = millis();
   	unsigned long timeUntilNextReading = 0;
 
-  	// Check WiFi connection
-  	if (!network.isConnected()) {
+  	// Finish the staged boot once WiFi is up
+  	if (!deviceRegistered && network.isConnected()) {
+    	registerDevice();
+  	}
+
+  	// Park the radio while nothing needs the network, and associate again ahead of the next upload.
+  	// Peers that try to fetch firmware meanwhile fall back to the server, the seeder listens again once WiFi is back
+  	if (ENABLE_RADIO_PARKING) {
+    	unsigned long untilNetworkNeeded = min(aggregator.getMillisUntilDue(currentMillis), updateScheduler.getMillisUntilDue(currentMillis));
+    	bool networkBusy = !deviceRegistered || uploadRawSamples || unsentAlerts != 0 ||
+    	                   network.isUpdateInProgress() || network.isOTAWindowOpen();
+    	if (network.isRadioParked()) {
+      		if (networkBusy || untilNetworkNeeded <= POWER_RADIO_WAKE_LEAD) {
+        		network.wakeRadio();
+      		}
+    	} else if (!networkBusy && network.isConnected() && untilNetworkNeeded > POWER_RADIO_PARK_MIN_GAP) {
+      		network.parkRadio();
+    	}
+  	}
+
+  	// Check WiFi connection, leaving the boot-time association alone until it times out
+  	if (!network.isConnected() && !network.isConnecting() && !network.isRadioParked()) {
     	display.showSadFace();
     	fancyLog.toSerial("WiFi disconnected. Reconnecting...", WARNING);
     	network.connectWiFi();
   	}
 
+  	// Sample faster while the occupancy detector sees the room changing, if the battery allows it
+  	unsigned long samplingInterval = dutyPolicy.getSamplingInterval();
+  	if (occupancy.isChangeDetected() && dutyPolicy.allowsFastSampling()) {
+    	samplingInterval = OCCUPANCY_FAST_INTERVAL;
+  	}
+
   	// Calculate time until next reading
-  	if (currentMillis - previousMillis < LOOP_INTERVAL) {
-    	timeUntilNextReading = LOOP_INTERVAL - (currentMillis - previousMillis);
+  	if (currentMillis - previousMillis < samplingInterval) {
+    	timeUntilNextReading = samplingInterval - (currentMillis - previousMillis);
 
     	// Every 10 seconds, show time remaining until next data transmission
     	if (timeUntilNextReading % 10000 < 100) {
@@ -125,93 +227,486 @@ void loop() {
     	}
   	}
 
-  	// Regular sensor readings and data transmission
-  	if (currentMillis - previousMillis >= LOOP_INTERVAL) {
+  	// Start a sensor measurement, the frame is decoded in the background
+  	// The first one goes out as soon as the sensors have warmed up
+  	if (sensors.isReady() && (!samplingStarted || currentMillis - previousMillis >= samplingInterval)) {
     	previousMillis = currentMillis;
+    	samplingStarted = true;
+
+    	// One sampling cycle ends where the next begins
+    	power.closeCycle(battery.getVoltage() * VOLTAGE_TO_BATTERY, currentMillis);
+    	fancyLog.toSerial("Cycle energy: " + String(power.getCycleEnergy(), 0) + " mJ over " + String(power.getCycleMillis()) +
+    	                  " ms | avg " + String(power.getAverageCurrent(), 1) + " mA | asleep " + String(power.getSleepPercent(), 0) + "%");
+
+    	// Trade resolution for runtime as the charge drops or the link gets weak
+    	if (dutyPolicy.update(battery.getPercentage(), network.getRSSI())) {
+      		aggregator.setWindowLength(dutyPolicy.getWindowLength());
+      		reporter.setHeartbeatInterval(dutyPolicy.getUploadInterval());
+      		fancyLog.toSerial("Duty policy: " + String(dutyPolicy.getName()) + " | sampling " + String(dutyPolicy.getSamplingInterval() / 1000) +
+      		                  "s | window " + String(dutyPolicy.getWindowLength() / 1000) + "s | heartbeat " +
+      		                  String(dutyPolicy.getUploadInterval() / 1000) + "s", INFO);
+    	}
 
     	fancyLog.toSerial("Taking sensor readings", INFO);
+    	sensors.startReading();
+  	}
+
+  	// Finish a running measurement without blocking
+  	sensors.poll();
+
+  	// Regular sensor readings and data transmission, once the frame has arrived
+  	if (sensors.hasNewReading()) {
+    	// Read sensor data, all channels come from the same batch
+    	SensorReading reading = sensors.read();
+
+    	// Drop impossible values and smooth the rest before they reach the buffer
+    	readingFilter.apply(reading);
+    	worstFilterMicros = max(worstFilterMicros, readingFilter.getLastCostMicros());
+    	if (millis() - previousFilterLogMillis >= FILTER_LOG_INTERVAL) {
+      		fancyLog.toSerial("Filter cost: " + String(readingFilter.getLastCostMicros()) + " us (worst " + String(worstFilterMicros) + " us)");
+      		previousFilterLogMillis = millis();
+      		worstFilterMicros = 0;
+    	}
+
+    	// Dew point, heat index and absolute humidity from the filtered values
+    	addDerivedChannels(reading);
+    	if (reading.has(CHANNEL_TEMPERATURE)) {
+      		battery.setTemperature(reading.values[CHANNEL_TEMPERATURE]); // Cold batteries read low
+    	}
+    	if (ENABLE_OCCUPANCY) {
+      		occupancy.update(reading, millis());
+    	}
 
-    	// Read sensor data
-    	float temperature = sensors.readTemperature();
-    	float humidity = sensors.readHumidity();
-    	float batteryVoltage = battery.readVoltage();
-    	int batteryPercentage = battery.readPercentage(batteryVoltage);
-    	int batteryTimeRemaining = battery.estimateTimeRemaining(batteryPercentage);
+    	float batteryVoltage = battery.getVoltage();
+    	int batteryPercentage = battery.getPercentage();
+    	int batteryTimeRemaining = battery.getTimeRemaining();
+    	if (ENABLE_TRACE_REPLAY && !isnan(traceReplay.getBatteryVoltage())) {
+      		batteryVoltage = traceReplay.getBatteryVoltage();
+      		batteryPercentage = battery.readPercentage(batteryVoltage);
+      		batteryTimeRemaining = battery.estimateTimeRemaining(batteryPercentage);
+    	}
 
-    	if (isnan(temperature) || isnan(humidity)) {
+    	if (reading.status == SENSOR_READ_FAILED) {
       		fancyLog.toSerial("Failed to read sensor", ERROR);
       		display.showSadFace();
       		return;
     	}
 
-    	// Store in buffer
-    	dataBuffer[dataCount] = {
-      		temperature,
-      		humidity,
-      		batteryVoltage,
-      		batteryPercentage,
-      		batteryTimeRemaining,
-      		now()  // Use Unix timestamp from TimeLib instead of millis()
-    	};
-    	dataCount++;
+    	if (firstReadingMillis == 0) {
+      		firstReadingMillis = millis();
+      		fancyLog.toSerial("Time to first reading: " + String(firstReadingMillis) + " ms", INFO);
+    	}
+
+    	// Alerts skip the aggregation window and go out right away, failed ones back off
+    	uint16_t changedAlerts = alerts.evaluate(reading, millis());
+    	unsentAlerts |= changedAlerts;
+    	for (int i = 0; i < MAX_ALERT_RULES; i++) {
+      		if (changedAlerts & (1 << i)) {
+        		alertRetryDelay[i] = 0; // A new state is worth an attempt of its own
+      		}
+      		if (!(unsentAlerts & (1 << i)) || millis() - alertRetryMillis[i] < alertRetryDelay[i]) {
+        		continue;
+      		}
+      		if (sendAlert(i)) {
+        		unsentAlerts &= ~(1 << i);
+        		continue;
+      		}
+      		alertRetryMillis[i] = millis();
+      		alertRetryDelay[i] = alertRetryDelay[i] == 0 ? ALERT_RETRY_INTERVAL : min(alertRetryDelay[i] * 2, ALERT_RETRY_MAX_INTERVAL);
+      		fancyLog.toSerial("Alert " + String(i) + " not sent, retrying in " + String(alertRetryDelay[i] / 1000) + "s", WARNING);
+      		break; // The server is unreachable, do not block the pass on the other rules
+    	}
+
+    	bool uploaded = false;
+
+    	// Close the window before adding, so a summary never spans more than the window length.
+    	// With an update waiting the reading goes into the closing window, so nothing is left behind
+    	bool windowDue = aggregator.isWindowDue(millis());
+    	bool flushForUpdate = windowDue && network.isUpdateReady();
+    	if (flushForUpdate) {
+      		aggregator.add(reading, now(), millis());
+    	}
+    	if (windowDue) {
+      		WindowSummary summary;
+      		aggregator.takeSummary(summary);
+      		uploaded = sendSummary(summary, batteryVoltage, batteryPercentage, batteryTimeRemaining);
+    	}
+    	if (!flushForUpdate) {
+      		aggregator.add(reading, now(), millis());
+    	}
 
-    	// If buffer is full, send data
-    	if (dataCount >= DATA_BUFFER_SIZE) {
-      		sendBufferedData();
-      		dataCount = 0;
+    	// Raw samples go through the buffer only when asked for
+    	if (uploadRawSamples) {
+      		SensorData& data = dataBuffer[dataCount];
+      		memcpy(data.values, reading.values, sizeof(data.values));
+      		data.channelMask = reading.channelMask;
+      		data.batteryVoltage = batteryVoltage;
+      		data.batteryPercentage = batteryPercentage;
+      		data.batteryTimeRemaining = batteryTimeRemaining;
+      		data.timestamp = now();  // Use Unix timestamp from TimeLib instead of millis()
+      		dataCount++;
+
+      		// If buffer is full, send data
+      		if (dataCount >= DATA_BUFFER_SIZE) {
+        		uploaded = sendBufferedData();
+        		dataCount = 0;
+      		}
     	}
 
-    	// Show happy face unless battery is low
-    	if (battery.isLowBattery()) {
-      		display.showNeutralFace(); // Use neutral face for low battery
-    	} else {
-      		display.showHappyFace();
+    	// Data just went out and nothing unsent is buffered, so this is the quiet moment for a pending update
+    	if (uploaded && dataCount == 0 && network.isUpdateReady()) {
+      		network.applyPendingUpdate();
+    	}
+
+    	// Show happy face unless an alert is active, battery is low or the room is uncomfortable,
+    	// keep the progress bar while a download is running
+    	if (!network.isUpdateInProgress()) {
+      		if (alerts.isAnyActive()) {
+        		display.showAlert();
+      		} else if (battery.isLowBattery()) {
+        		display.showNeutralFace(); // Use neutral face for low battery
+      		} else if (DISPLAY_FACE_FROM_COMFORT && reading.has(CHANNEL_PPD)) {
+        		float ppd = reading.values[CHANNEL_PPD];
+        		if (ppd <= COMFORT_HAPPY_PPD) {
+          			display.showHappyFace();
+        		} else if (ppd <= COMFORT_NEUTRAL_PPD) {
+          			display.showNeutralFace();
+        		} else {
+          			display.showSadFace();
+        		}
+      		} else {
+        		display.showHappyFace();
+      		}
     	}
   	}
 
+  	// Sample the battery once per period, everything else reads the snapshot
+  	battery.update(millis());
+
   	// Log battery status periodically
   	if (currentMillis - previousBatteryLogMillis >= BATTERY_LOG_INTERVAL) {
     	previousBatteryLogMillis = currentMillis;
     	battery.logStatus();
   	}
 
-  	// Check for updates periodically
-  	if (currentMillis - previousUpdateCheckMillis >= CHECK_INTERVAL) {
-    	previousUpdateCheckMillis = currentMillis;
+  	// Check for updates when the scheduler says so
+  	if (updateScheduler.isDue(currentMillis, now())) {
     	network.checkForUpdates();
+    	updateScheduler.onCheckCompleted(millis(), network.getNextCheckHint());
   	}
+
+  	// Nap until the next interrupt, downloads and the OTA listener want every pass they can get
+  	power.idle(!network.isUpdateInProgress() && !network.isOTAWindowOpen(), !network.isRadioParked());
 }
 
-void sendBufferedData() {
+// True once the server accepted the upload
+bool sendBufferedData() {
   	fancyLog.toSerial("Sending data", INFO);
 
     // Get the values we're sending
-    float temp = dataBuffer[0].temperature;
-    float hum = dataBuffer[0].humidity;
-    float batteryVoltage = dataBuffer[0].batteryVoltage;
-    int batteryPercentage = dataBuffer[0].batteryPercentage;
-    int batteryTimeRemaining = dataBuffer[0].batteryTimeRemaining;
-    unsigned long timestamp = dataBuffer[0].timestamp;
-
-    // Create the JSON document
-    StaticJsonDocument<384> jsonDoc;
+    SensorData& data = dataBuffer[0];
+    float batteryVoltage = data.batteryVoltage;
+    int batteryPercentage = data.batteryPercentage;
+    int batteryTimeRemaining = data.batteryTimeRemaining;
+    unsigned long timestamp = data.timestamp;
+
+    // Create the JSON document, on the heap as the worst case is too big for the loop stack
+    DynamicJsonDocument jsonDoc(RAW_UPLOAD_CAPACITY);
     jsonDoc["deviceId"] = DeviceIdentifier::getDeviceId();
-    jsonDoc["temperature"] = temp;
-    jsonDoc["humidity"] = hum;
+    for (int channel = 0; channel < SENSOR_CHANNEL_COUNT; channel++) {
+        if (data.channelMask & (1 << channel)) {
+            jsonDoc[getChannelName((SensorChannel)channel)] = data.values[channel];
+        }
+    }
     jsonDoc["batteryVoltage"] = batteryVoltage;
     jsonDoc["batteryPercentage"] = batteryPercentage;
     jsonDoc["batteryTimeRemaining"] = batteryTimeRemaining;
     jsonDoc["timestamp"] = timestamp;
 
+    return postUpload(jsonDoc, API_DATA_ROUTE);
+}
+
+// True only when the summary was posted, a suppressed window sends nothing
+bool sendSummary(const WindowSummary& summary, float batteryVoltage, int batteryPercentage, int batteryTimeRemaining) {
+    // Only send when the window is off the shared prediction, or the heartbeat is due.
+    // A policy change goes out right away, the server still waits with the old heartbeat
+    ReportReason reason = reporter.evaluate(summary, dutyPolicy.isChangePending(), millis());
+    if (reason == REPORT_SUPPRESSED) {
+        fancyLog.toSerial("Summary within deadband, suppressed (" + String(reporter.getSuppressedSinceReport()) + " since last upload)", INFO);
+        return false;
+    }
+
+  	fancyLog.toSerial("Sending window summary", INFO);
+
+    // One object per channel instead of one upload per sample
+    DynamicJsonDocument jsonDoc(SUMMARY_UPLOAD_CAPACITY);
+    jsonDoc["deviceId"] = DeviceIdentifier::getDeviceId();
+    jsonDoc["windowStart"] = summary.startTimestamp;
+    jsonDoc["windowEnd"] = summary.endTimestamp;
+    for (int channel = 0; channel < SENSOR_CHANNEL_COUNT; channel++) {
+        if (summary.channelMask & (1 << channel)) {
+            const ChannelSummary& stats = summary.channels[channel];
+            JsonObject channelStats = jsonDoc.createNestedObject(getChannelName((SensorChannel)channel));
+            channelStats["count"] = stats.count;
+            channelStats["min"] = stats.min;
+            channelStats["max"] = stats.max;
+            channelStats["mean"] = stats.mean;
+            channelStats["stddev"] = stats.stddev;
+        }
+    }
+    jsonDoc["batteryVoltage"] = batteryVoltage;
+    jsonDoc["batteryPercentage"] = batteryPercentage;
+    jsonDoc["batteryTimeRemaining"] = batteryTimeRemaining;
+    jsonDoc["timestamp"] = summary.endTimestamp;
+
+    // Lets the server tell a heartbeat from a change and count the windows it did not get
+    JsonObject report = jsonDoc.createNestedObject("report");
+    report["reason"] = reason == REPORT_HEARTBEAT ? "heartbeat" : reason == REPORT_CHANGED ? "change" : "policy";
+    report["suppressed"] = reporter.getSuppressedSinceReport();
+    report["forced"] = reporter.getForcedCount();
+    report["suppressionRatio"] = reporter.getSuppressionRatio();
+    report["modelVersion"] = REPORT_MODEL_VERSION;
+
+    if (!postUpload(jsonDoc, API_SUMMARY_ROUTE)) {
+        return false;
+    }
+    reporter.onReported(summary, millis());
+    return true;
+}
+
+// Adds the status that rides along with every upload and sends it
+bool postUpload(JsonDocument& jsonDoc, const char* route) {
+    // Outliers rejected by the filter since boot, only channels that had any
+    JsonObject rejected;
+    for (int channel = 0; channel < SENSOR_CHANNEL_COUNT; channel++) {
+        unsigned long count = readingFilter.getRejectedCount((SensorChannel)channel);
+        if (count > 0) {
+            if (rejected.isNull()) {
+                rejected = jsonDoc.createNestedObject("rejected");
+            }
+            rejected[getChannelName((SensorChannel)channel)] = count;
+        }
+    }
+
+    // Per-sensor health, so a wedged sensor shows up before it turns into a gap
+    JsonObject sensorHealth = jsonDoc.createNestedObject("health");
+    for (int i = 0; i < sensors.getDriverCount(); i++) {
+        const SensorHealth& stats = sensors.getHealth(i);
+        JsonObject driver = sensorHealth.createNestedObject(sensors.getDriverName(i));
+        driver["reads"] = stats.reads;
+        driver["failures"] = stats.failures;
+        driver["consecutive"] = stats.consecutiveFailures;
+        driver["latencyUs"] = stats.lastLatencyMicros;
+        driver["reinits"] = stats.reinits;
+    }
+
+    if (ENABLE_SOUND_SENSOR && !ENABLE_TRACE_REPLAY) {
+        JsonObject sound = sensorHealth[soundLevel.getName()];
+        sound["cpuLoad"] = soundLevel.getCpuLoad();
+        sound["droppedBlocks"] = soundLevel.getDroppedBlocks();
+    }
+
+    // Estimated energy of the last sampling cycle
+    JsonObject powerStats = jsonDoc.createNestedObject("power");
+    powerStats["cycleEnergy"] = power.getCycleEnergy();
+    powerStats["averageCurrent"] = power.getAverageCurrent();
+    powerStats["sleepPercent"] = power.getSleepPercent();
+
+    // Measured drain, the time remaining is based on it once known
+    if (!isnan(battery.getDrainRate())) {
+        jsonDoc["batteryDrainRate"] = battery.getDrainRate();
+    }
+
+    // Rollout progress rides along with the regular upload instead of opening a connection
+    bool otaReportAttached = network.attachOTAReport(jsonDoc);
+    bool policyAttached = dutyPolicy.attachChange(jsonDoc);
+
+    // Boot timings go out once, with the upload after the first successful one
+    bool bootMetricsAttached = false;
+    if (firstUploadMillis != 0 && !bootMetricsReported) {
+        JsonObject boot = jsonDoc.createNestedObject("boot");
+        boot["firstReadingMs"] = firstReadingMillis;
+        boot["firstUploadMs"] = firstUploadMillis;
+        bootMetricsAttached = true;
+    }
+
+  	// A full document silently drops members, better to send nothing than a partial upload
+  	if (jsonDoc.overflowed()) {
+    	fancyLog.toSerial("Upload does not fit its JSON document (" + String(jsonDoc.capacity()) + " bytes), not sent", ERROR);
+    	return false;
+  	}
+
   	String sensorData;
   	serializeJson(jsonDoc, sensorData);
 
   	// Log the exact JSON format
   	fancyLog.toSerial("JSON Format: " + sensorData, INFO);
 
-  	if (network.sendHttpPostRequest(sensorData, API_DATA_ROUTE)) {
-    	fancyLog.toSerial("Data sent successfully", INFO);
-  	} else {
+  	if (!network.sendHttpPostRequest(sensorData, route)) {
     	fancyLog.toSerial("Failed to send data", ERROR);
+    	return false;
+  	}
+
+  	fancyLog.toSerial("Data sent successfully", INFO);
+  	if (policyAttached) {
+    	dutyPolicy.clearChange();
+  	}
+  	if (otaReportAttached) {
+    	network.clearOTAReport();
+  	}
+  	if (firstUploadMillis == 0) {
+    	firstUploadMillis = millis();
+    	fancyLog.toSerial("Time to first upload: " + String(firstUploadMillis) + " ms", INFO);
+  	}
+  	if (bootMetricsAttached) {
+    	bootMetricsReported = true;
+  	}
+  	return true;
+}
+
+// Priority path for alert state changes, sent on their own without the upload extras
+bool sendAlert(int index) {
+    const AlertRule& rule = alerts.getRule(index);
+
+    StaticJsonDocument<256> jsonDoc;
+    jsonDoc["deviceId"] = DeviceIdentifier::getDeviceId();
+    jsonDoc["rule"] = index;
+    jsonDoc["channel"] = getChannelName(rule.channel);
+    jsonDoc["condition"] = getAlertConditionName(rule.condition);
+    jsonDoc["threshold"] = rule.threshold;
+    jsonDoc["value"] = alerts.getLastMeasure(index);
+    jsonDoc["state"] = alerts.isActive(index) ? "triggered" : "cleared";
+    jsonDoc["timestamp"] = now();
+
+    String alertData;
+    serializeJson(jsonDoc, alertData);
+    fancyLog.toSerial("Alert: " + alertData, WARNING);
+
+    return network.sendHttpPostRequest(alertData, API_ALERT_ROUTE);
+}
+
+void registerDevice() {
+  	fancyLog.toSerial("WiFi connected | IP: " + WiFi.localIP().toString() + " | RSSI: " + String(WiFi.RSSI()) + " dBm", INFO);
+
+  	// Offer the running firmware to peers if it was installed from a verified image
+  	seeder.begin();
+
+  	// Register device with server
+  	StaticJsonDocument<512> jsonDoc;
+  	jsonDoc["deviceId"] = DeviceIdentifier::getDeviceId();
+  	jsonDoc["modelType"] = MODEL_TYPE;
+  	jsonDoc["firmwareVersion"] = FIRMWARE_VERSION;
+  	if (seeder.isSeeding()) {
+    	jsonDoc["seedPort"] = SEED_PORT;
+  	}
+  	// The heartbeat is only checked when a window closes, so the longest silence is one window more.
+  	// The server treats a device as dead after that
+  	jsonDoc["heartbeatSeconds"] = reporter.getHeartbeatInterval() / 1000;
+  	jsonDoc["maxSilenceSeconds"] = (reporter.getHeartbeatInterval() + aggregator.getWindowLength()) / 1000;
+
+  	// Predictor parameters, so the server can rebuild suppressed windows within the bounds
+  	JsonObject model = jsonDoc.createNestedObject("reportModel");
+  	model["version"] = REPORT_MODEL_VERSION;
+  	model["predictor"] = REPORT_PREDICTOR == PREDICTOR_LINEAR ? "linear" : "hold";
+  	JsonObject bounds = model.createNestedObject("bounds");
+  	for (int channel = 0; channel < SENSOR_CHANNEL_COUNT; channel++) {
+    	bounds[getChannelName((SensorChannel)channel)] = ENABLE_DEADBAND ? CHANNEL_DEADBAND[channel] : 0.0f;
+  	}
+
+  	String registerData;
+  	serializeJson(jsonDoc, registerData);
+  	network.sendHttpPostRequest(registerData, API_REGISTER_ROUTE);
+  	deviceRegistered = true;
+}
+
+void handleSerialCommands() {
+  	if (!Serial.available()) {
+    	return;
+  	}
+
+  	String command = Serial.readStringUntil('\n');
+  	command.trim();
+
+  	if (command == "ota") {
+    	network.openOTAWindow();
+  	} else if (command == "ota off") {
+    	network.closeOTAWindow();
+  	} else if (command == "raw on") {
+    	uploadRawSamples = true;
+    	fancyLog.toSerial("Raw sample upload enabled", INFO);
+  	} else if (command == "raw off") {
+    	uploadRawSamples = false;
+    	dataCount = 0;
+    	fancyLog.toSerial("Raw sample upload disabled", INFO);
+  	} else if (command.startsWith("alert")) {
+    	handleAlertCommand(command.substring(5));
+  	} else if (command.length() > 0) {
+    	fancyLog.toSerial("Unknown command: " + command, WARNING);
   	}
-}
\ No newline at end of file
+}
+
+// Splits off the first space separated word of args
+String nextToken(String& args) {
+  	args.trim();
+  	int space = args.indexOf(' ');
+  	String token = space < 0 ? args : args.substring(0, space);
+  	args = space < 0 ? "" : args.substring(space + 1);
+  	return token;
+}
+
+// "alert list", "alert clear <rule>" or "alert <rule> <channel> <above|below|rising|falling> <threshold> <hysteresis> <seconds>"
+void handleAlertCommand(String args) {
+  	String first = nextToken(args);
+
+  	if (first == "list" || first.length() == 0) {
+    	for (int i = 0; i < MAX_ALERT_RULES; i++) {
+      		const AlertRule& rule = alerts.getRule(i);
+      		if (rule.enabled) {
+        		fancyLog.toSerial("Alert " + String(i) + ": " + getChannelName(rule.channel) + " " + getAlertConditionName(rule.condition) + " " +
+                          		String(rule.threshold) + " (hysteresis " + String(rule.hysteresis) + ", " + String(rule.minDuration / 1000) + " s)" +
+                          		(alerts.isActive(i) ? " ACTIVE" : ""), INFO);
+      		}
+    	}
+    	return;
+  	}
+
+  	if (first == "clear") {
+    	int index = nextToken(args).toInt();
+    	if (index < 0 || index >= MAX_ALERT_RULES) {
+      		fancyLog.toSerial("Invalid alert rule", WARNING);
+      		return;
+    	}
+    	alerts.clearRule(index);
+    	unsentAlerts &= ~(1 << index);
+    	fancyLog.toSerial("Alert " + String(index) + " cleared", INFO);
+    	return;
+  	}
+
+  	int index = first.toInt();
+  	String channelName = nextToken(args);
+  	String conditionName = nextToken(args);
+  	float threshold = nextToken(args).toFloat();
+  	float hysteresis = nextToken(args).toFloat();
+  	unsigned long minDuration = nextToken(args).toInt() * 1000UL;
+
+  	AlertRule rule = { true, SENSOR_CHANNEL_COUNT, ALERT_ABOVE, threshold, hysteresis, minDuration };
+  	for (int channel = 0; channel < SENSOR_CHANNEL_COUNT; channel++) {
+    	if (channelName == getChannelName((SensorChannel)channel)) {
+      		rule.channel = (SensorChannel)channel;
+    	}
+  	}
+  	bool conditionFound = false;
+  	for (int condition = ALERT_ABOVE; condition <= ALERT_FALLING; condition++) {
+    	if (conditionName == getAlertConditionName((AlertCondition)condition)) {
+      		rule.condition = (AlertCondition)condition;
+      		conditionFound = true;
+    	}
+  	}
+
+  	if (!conditionFound || !alerts.setRule(index, rule)) {
+    	fancyLog.toSerial("Invalid alert rule", WARNING);
+    	return;
+  	}
+  	unsentAlerts &= ~(1 << index);
+  	fancyLog.toSerial("Alert " + String(index) + " set", INFO);
+}
@@ -5,7 +5,6 @@
 #include <Arduino.h>
 #include <TimeLib.h>
 #include <WiFiS3.h>
-#include <DHT.h>
 #include <EEPROM.h>
 #include <ArduinoJson.h>
 #include <Arduino_LED_Matrix.h>
@@ -31,6 +30,8 @@ constexpr const int SERVER_PORT = 3000;
 //¤============¤==========================================================================¤
 constexpr const char* API_REGISTER_ROUTE = "/api/device/register";
 constexpr const char* API_DATA_ROUTE = "/api/devices/readings";
+constexpr const char* API_SUMMARY_ROUTE = "/api/devices/summaries";
+constexpr const char* API_ALERT_ROUTE = "/api/devices/alerts";
 
 //¤======================¤
 //| Timing Configuration |
@@ -58,13 +59,203 @@ constexpr const int RETRY_ANIMATION_ON_TIME = 500;
 // Time in milliseconds that LED is off during retry animation
 constexpr const int RETRY_ANIMATION_OFF_TIME = 500;
 
+//¤===================¤
+//| OTA Configuration |
+//¤===================¤===================================================================¤
+// Maximum number of firmware bytes moved from the socket to flash per loop iteration
+constexpr const int OTA_CHUNK_SIZE = 512;
+// Abort a background download when no data has arrived for this long (10 seconds)
+constexpr const unsigned long OTA_STALL_TIMEOUT = 10000;
+// Abort a background download that takes longer than this in total (5 minutes)
+constexpr const unsigned long OTA_DOWNLOAD_TIMEOUT = 300000UL;
+// A gap between two received chunks longer than this is reported as a stall (1 second)
+constexpr const unsigned long OTA_STALL_REPORT_THRESHOLD = 1000;
+// Progress is reported to the server every time the download crosses this many percent
+constexpr const int OTA_REPORT_STEP_PERCENTAGE = 25;
+
+//¤============================¤
+//| Peer Seeding Configuration |
+//¤============================¤==========================================================¤
+// Serve the verified running firmware to peers and download from peers named in the manifest
+constexpr const bool ENABLE_PEER_SEEDING = false;
+// TCP port and route of the firmware seed endpoint
+constexpr const int SEED_PORT = 8070;
+constexpr const char* SEED_ROUTE = "/firmware";
+// Download attempts against a peer before falling back to the server
+constexpr const int SEED_MAX_ATTEMPTS = 2;
+// How long a peer gets to send its request headers before the seeder gives up (1 second)
+constexpr const unsigned long SEED_REQUEST_TIMEOUT = 1000;
+// How often the seeder checks the link, it listens again after the radio was parked or dropped (1 second)
+constexpr const unsigned long SEED_LINK_CHECK_INTERVAL = 1000;
+// Flash address the sketch is linked at (right after the 16 KB bootloader on the UNO R4)
+constexpr const uint32_t SKETCH_FLASH_START = 0x4000;
+
+//¤=========================¤
+//| Update Check Scheduling |
+//¤=========================¤=============================================================¤
+// First check after boot lands somewhere in this window, picked per device (5 minutes)
+constexpr const unsigned long UPDATE_CHECK_BOOT_SPREAD = 300000UL;
+// Per-device offset added to CHECK_INTERVAL so devices stay out of phase (up to 10 minutes)
+constexpr const unsigned long UPDATE_CHECK_JITTER = 600000UL;
+// Maintenance window in UTC hours [start, end), checks outside it are postponed
+// Equal values disable the window. Only applied once the clock has been set
+constexpr const int UPDATE_WINDOW_START_HOUR = 0;
+constexpr const int UPDATE_WINDOW_END_HOUR = 0;
+// Upper bound for a server-provided Retry-After / nextCheckSeconds hint (24 hours, in seconds)
+constexpr const unsigned long UPDATE_CHECK_MAX_HINT = 86400UL;
+
+//¤================================¤
+//| IDE OTA Listener Configuration |
+//¤================================¤======================================================¤
+// How long the ArduinoOTA listener stays open once requested (10 minutes)
+constexpr const unsigned long OTA_LISTENER_WINDOW = 600000UL;
+// Push button (to GND) that opens the listener, -1 when no button is fitted
+constexpr const int OTA_BUTTON_PIN = -1;
+
 //¤======================¤
 //| Sensor Configuration |
 //¤======================¤================================================================¤
 // Define the pin where DHT22 is connected
 constexpr const int DHT22_PIN = 2;
-// DHT sensor type definition
-#define DHTTYPE DHT22
+// The DHT22 cannot deliver a fresh frame more often than this (2 seconds)
+constexpr const unsigned long DHT22_MIN_SAMPLING_PERIOD = 2000;
+// Pin that switches the DHT22 supply so a wedged sensor can be power-cycled, -1 when it is always powered
+constexpr const int DHT22_POWER_PIN = -1;
+constexpr const unsigned long DHT22_POWER_OFF_TIME = 200; // Supply off time of a power cycle
+// Optional I2C sensors, registered next to the DHT22 when enabled
+constexpr const bool ENABLE_SHT3X = false;
+constexpr const uint8_t SHT3X_I2C_ADDRESS = 0x44;
+constexpr const bool ENABLE_SCD4X = false;
+constexpr const uint8_t SCD4X_I2C_ADDRESS = 0x62;
+// Channels computed on the device from temperature and humidity, uploaded like measured ones
+constexpr const bool ENABLE_DEW_POINT = true;
+constexpr const bool ENABLE_HEAT_INDEX = true;
+constexpr const bool ENABLE_ABSOLUTE_HUMIDITY = true;
+// ISO 7730 thermal comfort (PMV/PPD). Radiant temperature is taken equal to air temperature
+constexpr const bool ENABLE_COMFORT_INDEX = true;
+constexpr const float COMFORT_METABOLIC_RATE = 1.2; // met, seated office work
+constexpr const float COMFORT_CLOTHING = 0.7; // clo, trousers and long-sleeved shirt
+constexpr const float COMFORT_AIR_VELOCITY = 0.1; // m/s, still indoor air
+constexpr const int COMFORT_MAX_ITERATIONS = 50; // Bound on the clothing surface temperature solve
+// Show the face by PPD (happy up to 10 %, neutral up to 20 %, sad above) instead of always happy
+constexpr const bool DISPLAY_FACE_FROM_COMFORT = true;
+constexpr const float COMFORT_HAPPY_PPD = 10.0;
+constexpr const float COMFORT_NEUTRAL_PPD = 20.0;
+// Replay a trace in place of the real sensors, for benchmarking the pipeline without hardware
+constexpr const bool ENABLE_TRACE_REPLAY = false;
+constexpr const unsigned long TRACE_REPLAY_SPEEDUP = 60; // Trace seconds per real second
+// Maximum number of registered sensor drivers
+constexpr const int MAX_SENSOR_DRIVERS = 4;
+// Give up on drivers that have not finished a batch after this long (6 seconds, SCD4x needs 5)
+constexpr const unsigned long SENSOR_BATCH_TIMEOUT = 6000;
+// Sensors need this long after power-up before the first measurement (2 seconds)
+constexpr const unsigned long SENSOR_WARMUP_TIME = 2000;
+// Failed sensors are retried within the same sampling slot once their minimum sampling period allows
+constexpr const int SENSOR_MAX_RETRIES = 1;
+constexpr const unsigned long SENSOR_RETRY_MAX_DELAY = 3000; // A retry further into the slot than this is skipped
+// Re-initialize (or power-cycle) a sensor after this many failures in a row
+constexpr const int SENSOR_REINIT_THRESHOLD = 3;
+
+//¤===========================¤
+//| Sound Level Configuration |
+//¤===========================¤===========================================================¤
+// Analog microphone, registered as a sensor driver when enabled. Its 8 kHz sample interrupt
+// only collects the previous conversion and starts the next, a couple of microseconds, so it
+// does not skew the DHT22 edge timestamps (26 vs 70 µs pulses). Keep it free of blocking calls
+constexpr const bool ENABLE_SOUND_SENSOR = false;
+constexpr const int SOUND_PIN = A1;
+// Sample rate the A-weighting coefficients are designed for, do not change one without the other
+constexpr const float SOUND_SAMPLE_RATE = 8000.0;
+// Samples per ping-pong half (32 ms at 8 kHz)
+constexpr const int SOUND_BLOCK_SIZE = 256;
+// dB added to 10 * log10(mean square in ADC counts), found by comparing with a sound level meter
+constexpr const float SOUND_CALIBRATION_OFFSET = 0.0;
+
+//¤=========================¤
+//| Occupancy Configuration |
+//¤=========================¤=============================================================¤
+// Occupancy likelihood from humidity and temperature dynamics, added as a channel when enabled
+constexpr const bool ENABLE_OCCUPANCY = true;
+// Samples in the sliding window the slopes and variance are taken over (at most 16)
+constexpr const int OCCUPANCY_WINDOW = 12;
+// Feature levels that count as fully occupied
+constexpr const float OCCUPANCY_HUMIDITY_SLOPE = 0.5; // %RH per minute, people breathing
+constexpr const float OCCUPANCY_TEMPERATURE_SLOPE = 0.1; // °C per minute, body heat
+constexpr const float OCCUPANCY_HUMIDITY_VARIANCE = 0.25; // %RH squared, movement near the sensor
+// Share of each feature in the likelihood, in percent (sums to 100)
+constexpr const int OCCUPANCY_HUMIDITY_SLOPE_WEIGHT = 50;
+constexpr const int OCCUPANCY_TEMPERATURE_SLOPE_WEIGHT = 25;
+constexpr const int OCCUPANCY_HUMIDITY_VARIANCE_WEIGHT = 25;
+// The likelihood falls by at most this many percent per sample, so it does not flicker
+constexpr const int OCCUPANCY_DECAY = 5;
+// Sample at this interval while a change is detected (5 seconds)
+constexpr const unsigned long OCCUPANCY_FAST_INTERVAL = 5000;
+constexpr const int OCCUPANCY_CHANGE_LIKELIHOOD = 50; // Likelihood in percent that counts as a change
+
+//¤======================¤
+//| Filter Configuration |
+//¤======================¤================================================================¤
+// Filter stages, combined per channel below. Applied in the order median -> EMA -> Kalman
+constexpr const uint8_t FILTER_NONE = 0;
+constexpr const uint8_t FILTER_MEDIAN = 1;
+constexpr const uint8_t FILTER_EMA = 2;
+constexpr const uint8_t FILTER_KALMAN = 4;
+// Per-channel settings, in SensorChannel order: temperature, humidity, co2, pressure,
+// dew point, heat index, absolute humidity, sound level, occupancy, pmv, ppd. Derived channels are computed after filtering
+constexpr const uint8_t CHANNEL_FILTER_STAGES[] = { FILTER_MEDIAN | FILTER_KALMAN, FILTER_MEDIAN | FILTER_KALMAN, FILTER_MEDIAN | FILTER_EMA, FILTER_EMA, FILTER_NONE, FILTER_NONE, FILTER_NONE, FILTER_NONE, FILTER_NONE, FILTER_NONE, FILTER_NONE };
+// Physically possible range, values outside are rejected
+constexpr const float CHANNEL_MIN_VALUE[] = { -40.0, 0.0, 300.0, 30000.0, -40.0, -40.0, 0.0, 0.0, 0.0, -10.0, 0.0 };
+constexpr const float CHANNEL_MAX_VALUE[] = { 80.0, 100.0, 40000.0, 110000.0, 80.0, 100.0, 300.0, 140.0, 100.0, 10.0, 100.0 };
+// Largest believable change between two consecutive samples, bigger jumps are rejected
+constexpr const float CHANNEL_MAX_STEP[] = { 3.0, 15.0, 5000.0, 500.0, 10.0, 10.0, 10.0, 140.0, 100.0, 20.0, 100.0 };
+// Smoothing factor of the exponential moving average (0-1, higher follows faster)
+constexpr const float CHANNEL_EMA_ALPHA[] = { 0.3, 0.3, 0.3, 0.2, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 };
+// Kalman process noise and measurement noise variances, in channel units squared
+constexpr const float CHANNEL_KALMAN_Q[] = { 0.01, 0.1, 100.0, 4.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+constexpr const float CHANNEL_KALMAN_R[] = { 0.04, 1.0, 2500.0, 25.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+// Number of samples in the median window (odd, at most 7)
+constexpr const int FILTER_MEDIAN_WINDOW = 3;
+// After this many rejections in a row the new level is accepted as real
+constexpr const int FILTER_MAX_CONSECUTIVE_REJECTS = 3;
+// Filter cost logging interval, the line shows the worst cost since the previous one (10 minutes)
+constexpr const unsigned long FILTER_LOG_INTERVAL = 600000UL;
+
+//¤===========================¤
+//| Aggregation Configuration |
+//¤===========================¤===========================================================¤
+// Length of one summary window (1 minute), summaries are uploaded instead of raw samples
+constexpr const unsigned long AGGREGATION_WINDOW = 60000UL;
+// Also upload every raw sample. Can be changed at runtime with the "raw on" / "raw off" commands
+constexpr const bool UPLOAD_RAW_SAMPLES = false;
+// A summary is only uploaded when a channel mean is further than this from the predicted value
+constexpr const bool ENABLE_DEADBAND = true;
+constexpr const float CHANNEL_DEADBAND[] = { 0.2, 1.0, 25.0, 50.0, 0.3, 0.3, 0.3, 3.0, 10.0, 0.1, 2.0 }; // In SensorChannel order
+// Predictor shared with the server. Hold repeats the last uploaded value, linear extrapolates the last two
+constexpr const uint8_t PREDICTOR_HOLD = 0;
+constexpr const uint8_t PREDICTOR_LINEAR = 1;
+constexpr const uint8_t REPORT_PREDICTOR = PREDICTOR_LINEAR;
+// Bump whenever the prediction math changes, the server reconstructs with the matching version
+constexpr const int REPORT_MODEL_VERSION = 1;
+// Longest silence before a summary is uploaded anyway, so the server can tell unchanged from dead (15 minutes)
+constexpr const unsigned long REPORT_HEARTBEAT_INTERVAL = 900000UL;
+
+//¤=====================¤
+//| Alert Configuration |
+//¤=====================¤=================================================================¤
+constexpr const int MAX_ALERT_RULES = 8;
+// Default rules, can be replaced at runtime with the "alert" command
+constexpr const float ALERT_TEMPERATURE_HIGH = 28.0; // °C
+constexpr const float ALERT_TEMPERATURE_LOW = 16.0; // °C
+constexpr const float ALERT_HUMIDITY_HIGH = 70.0; // %
+constexpr const float ALERT_TEMPERATURE_RATE = 2.0; // °C per minute, like an open window in winter
+constexpr const float ALERT_TEMPERATURE_HYSTERESIS = 0.5;
+constexpr const float ALERT_HUMIDITY_HYSTERESIS = 3.0;
+constexpr const float ALERT_RATE_HYSTERESIS = 0.5;
+// A condition must hold this long before an alert triggers, and be gone this long before it clears (1 minute)
+constexpr const unsigned long ALERT_MIN_DURATION = 60000UL;
+// A failed alert upload is retried after this delay, doubling per failure up to the maximum (30 seconds, 10 minutes)
+constexpr const unsigned long ALERT_RETRY_INTERVAL = 30000UL;
+constexpr const unsigned long ALERT_RETRY_MAX_INTERVAL = 600000UL;
 
 //¤===========================¤
 //| Data Buffer Configuration |
@@ -76,21 +267,80 @@ constexpr const int DATA_BUFFER_SIZE = 1;
 //| Battery Monitor Configuration |
 //¤===============================¤=======================================================¤
 constexpr const int BATTERY_PIN = A0; // Analog pin for battery voltage reading
+// Conversions averaged per reading, back to back. 4^n samples add about n bits on a noisy input
+constexpr const int BATTERY_OVERSAMPLE_COUNT = 16;
+// The battery is sampled once per period, everything else reads the cached snapshot (10 seconds)
+constexpr const unsigned long BATTERY_SAMPLE_PERIOD = 10000;
+constexpr const float BATTERY_FILTER_ALPHA = 0.3; // Smoothing of successive samples (0-1, higher follows faster)
 
 // These are the actual voltage values of a 9V battery
 constexpr const float BATTERY_MAX_VOLTAGE = 9.0; // 9V battery max voltage
 constexpr const float BATTERY_MIN_VOLTAGE = 7.0; // Cutoff voltage for 9V battery
 
-// These values should match what your voltage divider is showing
-constexpr const float CALIBRATED_FULL_VOLTAGE = 0.7; // For a full 9V battery, your readings show ~0.7V
-constexpr const float CALIBRATED_EMPTY_VOLTAGE = 0.5; // For an empty battery (estimate)
-
-// This ratio is for display purposes only - to show the estimated actual battery voltage
-// Based on your readings of ~0.7V corresponding to an actual 9V battery
+// Voltage divider ratio, based on your readings of ~0.7V corresponding to an actual 9V battery
 constexpr const float VOLTAGE_TO_BATTERY = 13.0; // Multiplier to convert measured voltage to actual battery voltage
 
-// Estimated battery life in minutes at full charge
+// 9V alkaline discharge curve at room temperature, battery voltage to remaining charge.
+// Typical values, not fitted to a logged discharge of this board.
+// Interpolated linearly, voltages in descending order, 0% is where the board browns out
+constexpr const int BATTERY_CURVE_POINTS = 9;
+constexpr const float BATTERY_CURVE_VOLTAGE[BATTERY_CURVE_POINTS] = { 9.4, 9.0, 8.7, 8.4, 8.1, 7.8, 7.5, 7.2, 7.0 };
+constexpr const float BATTERY_CURVE_PERCENT[BATTERY_CURVE_POINTS] = { 100.0, 92.0, 80.0, 65.0, 50.0, 35.0, 20.0, 8.0, 0.0 };
+// Alkaline cells sag in the cold, volts added per °C below 25 °C before the lookup (6 cells x 3 mV)
+constexpr const float BATTERY_TEMPERATURE_COEFFICIENT = 0.018;
+
+// Time remaining comes from a regression over the charge history, one point per interval (5 minutes)
+constexpr const unsigned long BATTERY_TREND_INTERVAL = 300000UL;
+constexpr const int BATTERY_TREND_POINTS = 24; // 2 hours of history
+constexpr const int BATTERY_TREND_MIN_POINTS = 6; // Until then the estimate uses the rated battery life
+
+// Estimated battery life in minutes at full charge, used until the drain rate is known
 constexpr const int FULL_BATTERY_LIFE_MINUTES = 480; // 8 hours for a typical 9V battery
 constexpr const int LOW_BATTERY_THRESHOLD = 20; // Low battery warning threshold (percentage)
 
+
+//¤================================¤
+//| Power Management Configuration |
+//¤================================¤======================================================¤
+// Sleep the MCU between loop passes, any interrupt wakes it (millis tick, sensor edges, serial)
+constexpr const bool ENABLE_LOW_POWER = true;
+constexpr const bool POWER_WIFI_MODEM_SLEEP = true; // The WiFi module sleeps between beacons while associated
+
+// Disconnect the radio when nothing needs the network for a while
+constexpr const bool ENABLE_RADIO_PARKING = true;
+// Parked only when the next upload or update check is further away than this (2 minutes)
+constexpr const unsigned long POWER_RADIO_PARK_MIN_GAP = 120000UL;
+// Association starts this long before the network is needed again (20 seconds)
+constexpr const unsigned long POWER_RADIO_WAKE_LEAD = 20000UL;
+
+// Energy model for the per-cycle estimate, currents drawn from the battery side in mA
+constexpr const float POWER_BOARD_CURRENT = 12.0; // Regulator, power LED and LED matrix
+constexpr const float POWER_MCU_ACTIVE_CURRENT = 12.0; // RA4M1 running at 48 MHz
+constexpr const float POWER_MCU_SLEEP_CURRENT = 4.0; // RA4M1 in sleep mode, peripherals clocked
+constexpr const float POWER_RADIO_CURRENT = 45.0; // WiFi module associated, no power save
+constexpr const float POWER_RADIO_SLEEP_CURRENT = 20.0; // WiFi module associated, modem sleep
+constexpr const float POWER_RADIO_OFF_CURRENT = 12.0; // WiFi module up with the radio disconnected
+
+
+//¤==========================¤
+//| Duty Cycle Configuration |
+//¤==========================¤============================================================¤
+// Trade resolution for runtime as the battery drains. Off keeps the first policy
+constexpr const bool ENABLE_DUTY_CYCLING = true;
+// Policies from richest to leanest, one applies from its charge level down to the next one's
+constexpr const int DUTY_POLICY_COUNT = 4;
+constexpr const char* const DUTY_POLICY_NAME[DUTY_POLICY_COUNT] = { "full", "balanced", "saver", "critical" };
+constexpr const int DUTY_POLICY_MIN_PERCENT[DUTY_POLICY_COUNT] = { 50, 30, 15, 0 };
+constexpr const unsigned long DUTY_POLICY_SAMPLING_INTERVAL[DUTY_POLICY_COUNT] = { LOOP_INTERVAL, 30000UL, 60000UL, 300000UL };
+// Samples per window summary, the window is this many sampling intervals long
+constexpr const int DUTY_POLICY_BATCH_SIZE[DUTY_POLICY_COUNT] = { AGGREGATION_WINDOW / LOOP_INTERVAL, 10, 15, 6 };
+// Longest silence between uploads, the heartbeat of the deadband reporter
+constexpr const unsigned long DUTY_POLICY_UPLOAD_INTERVAL[DUTY_POLICY_COUNT] = { REPORT_HEARTBEAT_INTERVAL, 1800000UL, 3600000UL, 7200000UL };
+constexpr const bool DUTY_POLICY_FAST_SAMPLING[DUTY_POLICY_COUNT] = { true, true, false, false }; // Occupancy fast interval allowed
+// Charge needed above a richer policy's level before moving back to it (percent)
+constexpr const int DUTY_POLICY_HYSTERESIS = 5;
+// Uploads retry and keep the radio busy longer on a weak link, so it moves one policy leaner
+constexpr const long DUTY_WEAK_LINK_RSSI = -80; // dBm
+constexpr const long DUTY_LINK_HYSTERESIS = 5; // dB above the threshold before the link counts as good again
+
 #endif // CONFIG_H 
\ No newline at end of file
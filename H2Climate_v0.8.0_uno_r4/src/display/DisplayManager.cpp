@@ -19,6 +19,20 @@ void DisplayManager::showNeutralFace() {
     matrix.loadFrame(LEDMATRIX_EMOJI_BASIC);
 }
 
+void DisplayManager::showAlert() {
+    uint8_t exclamation[8][12] = {
+        {0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0},
+        {0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0}
+    };
+    matrix.renderBitmap(exclamation, 8, 12);
+}
+
 void DisplayManager::showRetryAnimation() {
     for (int i = 0; i < RETRY_ANIMATION_BLINKS; i++) {
         showNeutralFace();
@@ -111,30 +125,7 @@ void DisplayManager::showUpdateProgress(int percentage) {
         return;
     }
     
-    // Create a custom pattern for the update progress display
-    uint8_t progressFrame[8][12] = {
-        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}, // Top border
-        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
-        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
-        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
-        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
-        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}, // Bottom border
-        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
-    };
-    
-    // Calculate how many columns to fill based on percentage
-    int columnsToFill = map(percentage, 0, 100, 0, 10);
-    
-    // Fill in the progress bar
-    for (int row = 2; row <= 5; row++) {
-        for (int col = 1; col <= columnsToFill; col++) {
-            progressFrame[row][col] = 1;
-        }
-    }
-    
-    // Display the progress frame
-    matrix.renderBitmap(progressFrame, 8, 12);
+    showUpdateProgressBar(percentage);
     
     // Every 5 seconds or on specific percentage milestones, display percentage digits
     unsigned long currentMillis = millis();
@@ -192,10 +183,39 @@ void DisplayManager::showUpdateProgress(int percentage) {
         delay(1500);
         
         // Return to showing the progress bar
-        matrix.renderBitmap(progressFrame, 8, 12);
+        showUpdateProgressBar(percentage);
     }
 }
 
+void DisplayManager::showUpdateProgressBar(int percentage) {
+    percentage = constrain(percentage, 0, 100);
+    
+    // Create a custom pattern for the update progress display
+    uint8_t progressFrame[8][12] = {
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}, // Top border
+        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
+        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
+        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
+        {1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1},
+        {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}, // Bottom border
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}
+    };
+    
+    // Calculate how many columns to fill based on percentage
+    int columnsToFill = map(percentage, 0, 100, 0, 10);
+    
+    // Fill in the progress bar
+    for (int row = 2; row <= 5; row++) {
+        for (int col = 1; col <= columnsToFill; col++) {
+            progressFrame[row][col] = 1;
+        }
+    }
+    
+    // Display the progress frame
+    matrix.renderBitmap(progressFrame, 8, 12);
+}
+
 void DisplayManager::showUpdateInitializing() {
     // Show an animated loading spinner to indicate update initialization
     
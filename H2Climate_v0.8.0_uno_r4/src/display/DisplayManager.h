@@ -10,9 +10,11 @@ class DisplayManager {
     void showHappyFace();
     void showSadFace();
     void showNeutralFace();
+    void showAlert(); // Non-blocking, shown while an alert rule is active
     void showRetryAnimation();
     void showUpdateAvailable();
     void showUpdateProgress(int percentage);
+    void showUpdateProgressBar(int percentage); // Non-blocking, safe to call from the loop
     void showUpdateInitializing();
     void clear();
 
@@ -0,0 +1,167 @@
+#include "FirmwareSeeder.h"
+#include "../utils/Sha256.h"
+
+const int FIRMWARE_RECORD_ADDR = 64; // Address in EEPROM, placed after the device ID
+const uint32_t FIRMWARE_RECORD_MAGIC = 0x53454544; // "SEED"
+
+// Written right before an update is applied, checked again by the new firmware at boot
+struct FirmwareRecord {
+    uint32_t magic;
+    int32_t size;
+    char sha256[65];
+    char version[16];
+};
+
+FirmwareSeeder::FirmwareSeeder(FancyLog& fancyLog)
+    : fancyLog(fancyLog), server(SEED_PORT), seeding(false), listening(false), receiving(false), lastLinkCheckMillis(0),
+      requestStartMillis(0), image(nullptr), imageSize(0), sendOffset(0), sendEnd(0), request(0) {}
+
+//¤=======================================================================================¤
+
+void FirmwareSeeder::rememberImage(int size, const String& sha256, const String& version) {
+    FirmwareRecord record;
+    record.magic = FIRMWARE_RECORD_MAGIC;
+    record.size = size;
+    sha256.toCharArray(record.sha256, sizeof(record.sha256));
+    version.toCharArray(record.version, sizeof(record.version));
+    EEPROM.put(FIRMWARE_RECORD_ADDR, record);
+}
+
+//¤=======================================================================================¤
+
+void FirmwareSeeder::begin() {
+    if (!ENABLE_PEER_SEEDING) {
+        return;
+    }
+
+    FirmwareRecord record;
+    EEPROM.get(FIRMWARE_RECORD_ADDR, record);
+    record.sha256[64] = '\0';
+    record.version[15] = '\0';
+
+    if (record.magic != FIRMWARE_RECORD_MAGIC || String(record.version) != FIRMWARE_VERSION) {
+        fancyLog.toSerial("No verified image record for this firmware, not seeding", INFO);
+        return;
+    }
+
+    // The downloaded .bin is copied verbatim to the sketch start, so the running flash must hash the same
+    Sha256 hasher;
+    hasher.update(reinterpret_cast<const uint8_t*>(SKETCH_FLASH_START), record.size);
+    if (hasher.finishHex() != record.sha256) {
+        fancyLog.toSerial("Running image does not match its record, not seeding", WARNING);
+        return;
+    }
+
+    serve(reinterpret_cast<const uint8_t*>(SKETCH_FLASH_START), record.size);
+}
+
+void FirmwareSeeder::serve(const uint8_t* image, int size) {
+    this->image = image;
+    imageSize = size;
+    seeding = true;
+    // The server is started by the first link check in poll()
+    listening = false;
+    lastLinkCheckMillis = millis() - SEED_LINK_CHECK_INTERVAL;
+    fancyLog.toSerial("Seeding firmware " + String(FIRMWARE_VERSION) + " (" + String(imageSize) +
+                      " bytes) on port " + String(SEED_PORT), INFO);
+}
+
+//¤=======================================================================================¤
+
+void FirmwareSeeder::poll() {
+    if (!seeding || !checkLink()) {
+        return;
+    }
+
+    if (!client) {
+        client = server.available();
+        if (!client) {
+            return;
+        }
+        request = SeedRequest(imageSize);
+        requestLine = "";
+        requestStartMillis = millis();
+        receiving = true;
+    }
+
+    if (receiving) {
+        receiveRequest();
+        return;
+    }
+
+    if (!client.connected() || sendOffset >= sendEnd) {
+        client.stop();
+        return;
+    }
+
+    int chunkSize = min(OTA_CHUNK_SIZE, sendEnd - sendOffset);
+    int written = client.write(image + sendOffset, chunkSize);
+    if (written <= 0) {
+        client.stop();
+        return;
+    }
+    sendOffset += written;
+}
+
+//¤=======================================================================================¤
+
+bool FirmwareSeeder::checkLink() {
+    if (millis() - lastLinkCheckMillis < SEED_LINK_CHECK_INTERVAL) {
+        return listening;
+    }
+    lastLinkCheckMillis = millis();
+
+    // WiFi.end() takes the listening socket with it, so listen again once a parked or dropped radio is back.
+    // server.end() drops the stale socket number, begin() would otherwise keep it and do nothing
+    bool linked = WiFi.status() == WL_CONNECTED;
+    if (linked && !listening) {
+        server.begin();
+        fancyLog.toSerial("Seed server listening on port " + String(SEED_PORT));
+    } else if (!linked && listening) {
+        client.stop();
+        receiving = false;
+        server.end();
+    }
+    listening = linked;
+    return listening;
+}
+
+void FirmwareSeeder::receiveRequest() {
+    // Consume whatever has arrived, a Range header may come in a later segment than the request line
+    while (client.available() && !request.isComplete()) {
+        char c = client.read();
+        if (c == '\n') {
+            request.addLine(requestLine);
+            requestLine = "";
+        } else {
+            requestLine += c;
+        }
+    }
+
+    if (!request.isComplete()) {
+        if (!client.connected()) {
+            client.stop();
+            receiving = false;
+        } else if (millis() - requestStartMillis >= SEED_REQUEST_TIMEOUT) {
+            sendStatus("408 Request Timeout");
+        }
+        return;
+    }
+
+    receiving = false;
+    client.print(request.getResponseHeader());
+    if (request.getStatus() != 200 && request.getStatus() != 206) {
+        client.stop();
+        return;
+    }
+
+    sendOffset = request.getRangeStart();
+    sendEnd = request.getRangeEnd() + 1;
+    fancyLog.toSerial("Serving firmware bytes " + String(request.getRangeStart()) + "-" + String(request.getRangeEnd()) + " to a peer");
+}
+
+void FirmwareSeeder::sendStatus(const String& status) {
+    client.print("HTTP/1.1 " + status + "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+    client.stop();
+    receiving = false;
+}
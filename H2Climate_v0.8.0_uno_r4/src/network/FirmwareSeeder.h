@@ -0,0 +1,39 @@
+#ifndef FIRMWARE_SEEDER_H
+#define FIRMWARE_SEEDER_H
+
+#include "../config/Config.h"
+#include "../network/SeedRequest.h"
+#include "../utils/FancyLog.h"
+
+// Serves the running firmware image to peers over a minimal HTTP range endpoint.
+// Only images that were installed from a hash-verified download are served.
+class FirmwareSeeder {
+  public:
+    FirmwareSeeder(FancyLog& fancyLog);
+    void begin(); // Verifies the running image against the stored record and starts the server
+    void serve(const uint8_t* image, int size); // Starts serving an image that is already verified
+    void poll(); // Reads what the peer sent or sends at most one chunk per call, never waits
+    bool isSeeding() { return seeding; }
+    static void rememberImage(int size, const String& sha256, const String& version);
+
+  private:
+    FancyLog& fancyLog;
+    WiFiServer server;
+    WiFiClient client;
+    bool seeding;
+    bool listening;
+    bool receiving;
+    unsigned long lastLinkCheckMillis;
+    unsigned long requestStartMillis;
+    const uint8_t* image;
+    int imageSize;
+    int sendOffset;
+    int sendEnd;
+    SeedRequest request;
+    String requestLine; // Part of a header line that arrived without its newline yet
+    bool checkLink();
+    void receiveRequest();
+    void sendStatus(const String& status);
+};
+
+#endif // FIRMWARE_SEEDER_H
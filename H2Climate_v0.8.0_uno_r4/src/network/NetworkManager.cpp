@@ -1,23 +1,103 @@
 #include "NetworkManager.h"
+#include "../network/UpdateScheduler.h"
 
 NetworkManager::NetworkManager(FancyLog& fancyLog, OTAManager& otaManager, DisplayManager& display)
-    : fancyLog(fancyLog), otaManager(otaManager), display(display), updateAvailable(false) {}
+    : fancyLog(fancyLog), otaManager(otaManager), display(display), updateAvailable(false),
+      updateState(UPDATE_IDLE), updateSize(0), updateReceived(0), updateProgressPercentage(-1),
+      updateStartMillis(0), updateLastDataMillis(0), updateStorageOpen(false),
+      updateFromSeed(false), seedPort(SEED_PORT), seedAttempts(0), nextCheckHintSeconds(0),
+      otaWindowOpen(false), otaWindowStart(0), otaWindowLength(0), otaPollCount(0), otaPollMicros(0),
+      otaPollMaxMicros(0), connectStartMillis(0), radioParked(false) {
+    otaReport.pending = false;
+}
 
 void NetworkManager::begin() {
-    // Connect to WiFi
-    connectWiFi();
+    // Start associating, isConnected() tells when the link is up
+    fancyLog.toSerial("Connecting to WiFi: " + String(WIFI_SSID), INFO);
+    connectStartMillis = millis();
+    // WiFiS3 waits up to 10 s inside begin() for the link by default, return once the command is out.
+    // connectWiFi() keeps its own wait loop, so it is not affected
+    WiFi.setTimeout(0);
+    WiFi.begin(WIFI_SSID, WIFI_PASS);
+    if (POWER_WIFI_MODEM_SLEEP) {
+        WiFi.lowPowerMode(); // Sleep between beacons, the access point buffers traffic meanwhile
+    }
     
-    // Initialize OTA
-    OTAManager::begin(WiFi.localIP(), WIFI_SSID, WIFI_PASS);
+    // The IDE OTA listener stays closed until openOTAWindow() is requested
+}
+
+void NetworkManager::parkRadio() {
+    fancyLog.toSerial("Parking WiFi radio", INFO);
+    WiFi.disconnect();
+    WiFi.end();
+    radioParked = true;
+}
+
+void NetworkManager::wakeRadio() {
+    radioParked = false;
+    begin();
+}
+
+void NetworkManager::openOTAWindow(unsigned long durationMillis) {
+    if (!isConnected()) {
+        fancyLog.toSerial("WiFi not connected, cannot open OTA listener", WARNING);
+        return;
+    }
+    
+    if (!otaWindowOpen) {
+        OTAManager::begin(WiFi.localIP(), WIFI_SSID, WIFI_PASS);
+        otaWindowOpen = true;
+        otaPollCount = 0;
+        otaPollMicros = 0;
+        otaPollMaxMicros = 0;
+    }
+    
+    // Requesting again while open extends the window
+    otaWindowStart = millis();
+    otaWindowLength = durationMillis;
+    fancyLog.toSerial("OTA listener open for " + String(durationMillis / 1000) + "s at " +
+                      WiFi.localIP().toString(), INFO);
+}
+
+void NetworkManager::closeOTAWindow() {
+    if (!otaWindowOpen) {
+        return;
+    }
+    
+    OTAManager::end();
+    otaWindowOpen = false;
+    
+    unsigned long averageMicros = otaPollCount > 0 ? otaPollMicros / otaPollCount : 0;
+    fancyLog.toSerial("OTA listener closed | polls: " + String(otaPollCount) +
+                      " | avg: " + String(averageMicros) + " us | max: " + String(otaPollMaxMicros) + " us", INFO);
 }
 
 void NetworkManager::pollOTA() {
+    if (!otaWindowOpen) {
+        return;
+    }
+    
+    if (millis() - otaWindowStart >= otaWindowLength) {
+        closeOTAWindow();
+        return;
+    }
+    
+    // Measure what the listener costs per loop pass
+    unsigned long startMicros = micros();
     OTAManager::poll();
+    unsigned long elapsedMicros = micros() - startMicros;
+    
+    otaPollCount++;
+    otaPollMicros += elapsedMicros;
+    if (elapsedMicros > otaPollMaxMicros) {
+        otaPollMaxMicros = elapsedMicros;
+    }
 }
 
 bool NetworkManager::connectWiFi() {
     fancyLog.toSerial("Connecting to WiFi: " + String(WIFI_SSID), INFO);
     display.showNeutralFace();
+    radioParked = false;
     
     if (WiFi.status() == WL_CONNECTED) {
         WiFi.disconnect();
@@ -47,6 +127,10 @@ bool NetworkManager::connectWiFi() {
         delay(500);
     }
     
+    if (POWER_WIFI_MODEM_SLEEP) {
+        WiFi.lowPowerMode();
+    }
+    
     if (WiFi.status() == WL_CONNECTED && WiFi.localIP()[0] != 0) {
 		fancyLog.toSerial("WiFi connected successfully | IP: " + WiFi.localIP().toString() +
 						  " | RSSI: " + String(WiFi.RSSI()) + " dBm", INFO);
@@ -99,6 +183,11 @@ bool NetworkManager::sendHttpPostRequest(String jsonPayload, String apiRoute) {
             if (wifiClient.available()) {
                 String response = wifiClient.readString();
                 wifiClient.stop();
+
+                int dateHeader = response.indexOf("\nDate:");
+                if (dateHeader >= 0) {
+                    syncClock(response.substring(dateHeader + 1));
+                }
                 
                 if (response.indexOf("200 OK") > 0 || response.indexOf("201 Created") > 0) {
                     fancyLog.toSerial("Data sent successfully to " + apiRoute);
@@ -119,6 +208,14 @@ bool NetworkManager::sendHttpPostRequest(String jsonPayload, String apiRoute) {
 }
 
 void NetworkManager::checkForUpdates() {
+    // A hint belongs to the check that returned it, a failed check falls back to the normal interval
+    nextCheckHintSeconds = 0;
+
+    if (updateState != UPDATE_IDLE) {
+        fancyLog.toSerial("Firmware update already in progress, skipping update check", INFO);
+        return;
+    }
+    
     fancyLog.toSerial("Checking for firmware updates...", INFO);
     fancyLog.toSerial("Current version: " + String(FIRMWARE_VERSION), INFO);
     display.showNeutralFace();
@@ -155,6 +252,7 @@ void NetworkManager::checkForUpdates() {
     bool responseReceived = false;
     bool headersEnded = false;
     String jsonBody = "";
+    bool statusOk = true;
     
     while (millis() - timeout < API_TIMEOUT) {
         if (wifiClient.available()) {
@@ -167,15 +265,19 @@ void NetworkManager::checkForUpdates() {
             if (line.startsWith("HTTP/1.")) {
                 fancyLog.toSerial("Response status: " + line);
                 if (line.indexOf("200 OK") < 0) {
+                    // Keep reading the headers, a busy server may still send Retry-After
                     fancyLog.toSerial("Server returned non-200 status: " + line);
-                    wifiClient.stop();
-                    display.showSadFace();
-                    return;
+                    statusOk = false;
                 }
             }
             
             // Detect end of headers
             if (line == "\r") {
+                if (!statusOk) {
+                    wifiClient.stop();
+                    display.showSadFace();
+                    return;
+                }
                 headersEnded = true;
                 fancyLog.toSerial("Headers ended, reading body...", INFO);
                 continue;
@@ -190,6 +292,16 @@ void NetworkManager::checkForUpdates() {
                     line.startsWith("Content-Length:")) {
                     fancyLog.toSerial("Header: " + line);
                 }
+                
+                if (line.startsWith("Date:")) {
+                    syncClock(line);
+                }
+
+                // Server asks us to come back later (delta-seconds form only)
+                if (line.startsWith("Retry-After:")) {
+                    fancyLog.toSerial("Header: " + line);
+                    nextCheckHintSeconds = line.substring(12).toInt();
+                }
             }
         }
         
@@ -239,10 +351,22 @@ void NetworkManager::checkForUpdates() {
     display.showSadFace();
 }
 
+void NetworkManager::syncClock(const String& dateHeader) {
+    // The server clock is good to a second, which is all the timestamps and the maintenance window need
+    time_t serverTime = parseHttpDate(dateHeader.c_str() + 5);
+    if (serverTime == 0) {
+        return;
+    }
+    if (now() < MIN_VALID_EPOCH) {
+        fancyLog.toSerial("Clock set from server: " + dateHeader.substring(5), INFO);
+    }
+    setTime(serverTime);
+}
+
 bool NetworkManager::handleUpdateResponse(String& jsonBody) {
     fancyLog.toSerial("Parsing update response: " + jsonBody);
     
-    StaticJsonDocument<512> jsonDoc;
+    StaticJsonDocument<768> jsonDoc;
     DeserializationError error = deserializeJson(jsonDoc, jsonBody);
     
     if (error) {
@@ -258,6 +382,17 @@ bool NetworkManager::handleUpdateResponse(String& jsonBody) {
     
     updateAvailable = jsonDoc["updateAvailable"].as<bool>();
     
+    // Server may ask for the IDE OTA listener, e.g. before a manual flash
+    unsigned long otaWindowSeconds = jsonDoc["openOtaWindowSeconds"] | 0UL;
+    if (otaWindowSeconds > 0) {
+        openOTAWindow(otaWindowSeconds * 1000UL);
+    }
+    
+    // Optional hint for when this device should check again
+    if (jsonDoc.containsKey("nextCheckSeconds")) {
+        nextCheckHintSeconds = jsonDoc["nextCheckSeconds"].as<unsigned long>();
+    }
+    
     if (!updateAvailable) {
         String message = jsonDoc["message"] | "No updates available";
         fancyLog.toSerial("Update Status: " + message);
@@ -280,9 +415,6 @@ bool NetworkManager::handleUpdateResponse(String& jsonBody) {
     fancyLog.toSerial("Latest firmware version: " + latestFirmwareVersion, INFO);
     fancyLog.toSerial("Current firmware version: " + String(FIRMWARE_VERSION), INFO);
     
-    // Show update is available
-    display.showUpdateAvailable();
-    
     String downloadUrl = "/api/firmware/download?deviceId=" + DeviceIdentifier::getDeviceId() +
                         "&version=" + latestFirmwareVersion +
                         "&modelType=" + String(MODEL_TYPE);
@@ -295,184 +427,336 @@ bool NetworkManager::handleUpdateResponse(String& jsonBody) {
     
     fancyLog.toSerial("Firmware size: " + String(firmwareSize) + " bytes", INFO);
     
-    // Wait a moment to show that update is available before starting download
-    delay(2000);
+    updateSha256 = jsonDoc["sha256"] | "";
+    if (updateSha256.length() != 64) {
+        fancyLog.toSerial("Manifest has no sha256, the image cannot be verified", WARNING);
+        updateSha256 = "";
+    }
+    updateSha256.toLowerCase(); // Servers may send the digest in either case, the record and the seeders compare lowercase
+    
+    // Peers are only trusted when the manifest hash can verify what they send
+    seedHost = "";
+    JsonArray seeds = jsonDoc["seeds"];
+    if (ENABLE_PEER_SEEDING && updateSha256.length() > 0 && seeds.size() > 0) {
+        // Spread the fleet over the available seeds by device ID
+        String deviceId = DeviceIdentifier::getDeviceId();
+        unsigned int spread = 0;
+        for (unsigned int i = 0; i < deviceId.length(); i++) {
+            spread += deviceId[i];
+        }
+        String seed = seeds[spread % seeds.size()].as<String>();
+        int colon = seed.indexOf(':');
+        seedHost = colon > 0 ? seed.substring(0, colon) : seed;
+        seedPort = colon > 0 ? seed.substring(colon + 1).toInt() : SEED_PORT;
+    }
     
-    return downloadAndApplyUpdate(downloadUrl, firmwareSize);
+    // Hand the download over to the background job, pollUpdate() moves it forward
+    startUpdateDownload(downloadUrl, firmwareSize);
+    return true;
 }
 
-bool NetworkManager::downloadAndApplyUpdate(String& downloadUrl, int firmwareSize) {
-    if (!wifiClient.connect(SERVER_URL, SERVER_PORT)) {
-        fancyLog.toSerial("Failed to connect to download server", ERROR);
-        return false;
+void NetworkManager::startUpdateDownload(String& downloadUrl, int firmwareSize) {
+    updateUrl = downloadUrl;
+    updateSize = firmwareSize;
+    updateFromSeed = seedHost.length() > 0;
+    seedAttempts = 0;
+    updateStartMillis = millis();
+    resetUpdateDownload();
+    
+    otaReport.version = latestFirmwareVersion;
+    otaReport.reason = "";
+    otaReport.stalls = 0;
+    otaReport.retries = 0;
+    updateOTAReport("downloading");
+    
+    fancyLog.toSerial("Queued background firmware download", INFO);
+    fancyLog.toSerial("Update size: " + String(updateSize) + " bytes");
+    fancyLog.toSerial("Download URL: " + updateUrl);
+    if (updateFromSeed) {
+        fancyLog.toSerial("Downloading from peer seed " + seedHost + ":" + String(seedPort), INFO);
+    }
+    display.showUpdateProgressBar(0);
+}
+
+void NetworkManager::resetUpdateDownload() {
+    updateReceived = 0;
+    updateProgressPercentage = -1; // Start with -1 to ensure first update is shown
+    updateLastDataMillis = millis();
+    updateStorageOpen = false;
+    updateHasher.reset();
+    updateState = UPDATE_CONNECTING;
+}
+
+void NetworkManager::pollUpdate() {
+    // The total timeout covers every step, a download that never gets WiFi back is still ended
+    if (updateState != UPDATE_IDLE && updateState != UPDATE_READY && millis() - updateStartMillis > OTA_DOWNLOAD_TIMEOUT) {
+        updateFromSeed = false; // Out of time, do not fall back
+        failUpdateDownload("Download timeout - total timeout exceeded");
+        return;
+    }
+
+    switch (updateState) {
+        case UPDATE_CONNECTING:
+            pollUpdateConnect();
+            break;
+        case UPDATE_HEADERS:
+            pollUpdateHeaders();
+            break;
+        case UPDATE_DOWNLOADING:
+            pollUpdateDownload();
+            break;
+        default:
+            break; // Nothing to do while idle or waiting for a quiet window
+    }
+}
+
+void NetworkManager::pollUpdateConnect() {
+    if (!isConnected()) {
+        return; // The loop reconnects WiFi, try again on a later pass
     }
     
-    fancyLog.toSerial("Downloading firmware update", INFO);
-    fancyLog.toSerial("Update size: " + String(firmwareSize) + " bytes");
-    fancyLog.toSerial("Download URL: " + downloadUrl);
+    String host = updateFromSeed ? seedHost : String(SERVER_URL);
+    int port = updateFromSeed ? seedPort : SERVER_PORT;
+    String path = updateFromSeed ? String(SEED_ROUTE) + "?version=" + latestFirmwareVersion : updateUrl;
     
-    // Show update initialization animation
-    display.showUpdateInitializing();
+    if (!otaClient.connect(host.c_str(), port)) {
+        failUpdateDownload("Failed to connect to download server " + host);
+        return;
+    }
     
     String downloadRequest =
-        "GET " + downloadUrl + " HTTP/1.1\r\n" +
-        "Host: " + String(SERVER_URL) + "\r\n" +
-        "Connection: close\r\n\r\n";
-    
-    wifiClient.print(downloadRequest);
+        "GET " + path + " HTTP/1.1\r\n" +
+        "Host: " + host + "\r\n";
     
-    // Add timeout for header reading
-    unsigned long headerTimeout = millis();
-    bool headerFound = false;
+    // Seeds serve byte ranges, so an interrupted peer download resumes where it stopped
+    if (updateFromSeed) {
+        downloadRequest += "Range: bytes=" + String(updateReceived) + "-\r\n";
+    }
+    downloadRequest += "Connection: close\r\n\r\n";
     
-    // Skip headers with timeout
-    while (!headerFound && millis() - headerTimeout < API_TIMEOUT) {
-        if (wifiClient.available()) {
-            String line = wifiClient.readStringUntil('\n');
-            fancyLog.toSerial("Header: " + line);
-            if (line == "\r") {
-                headerFound = true;
-                break;
+    otaClient.print(downloadRequest);
+    updateLastDataMillis = millis();
+    updateState = UPDATE_HEADERS;
+}
+
+void NetworkManager::pollUpdateHeaders() {
+    // Consume whatever header lines have arrived, never wait for more
+    while (otaClient.available()) {
+        String line = otaClient.readStringUntil('\n');
+        updateLastDataMillis = millis();
+        
+        if (line.startsWith("HTTP/1.")) {
+            bool partial = line.indexOf("206 Partial Content") > 0;
+            if (line.indexOf("200 OK") < 0 && !partial) {
+                failUpdateDownload("Download server returned: " + line);
+                return;
+            }
+            if (updateReceived > 0 && !partial) {
+                failUpdateDownload("Download server ignored the resume range");
+                return;
             }
         }
-        delay(10);
-    }
-    
-    if (!headerFound) {
-        fancyLog.toSerial("Failed to find header end marker", ERROR);
-        wifiClient.stop();
-        return false;
+        
+        if (line == "\r") {
+            if (!updateStorageOpen) {
+                // Initialize OTA update
+                fancyLog.toSerial("Initializing OTA update storage", INFO);
+                if (!OTAManager::beginUpdate(updateSize)) {
+                    failUpdateDownload("Failed to initialize storage for update");
+                    return;
+                }
+                updateStorageOpen = true;
+                fancyLog.toSerial("Started firmware update process", INFO);
+            }
+            
+            updateState = UPDATE_DOWNLOADING;
+            return;
+        }
     }
     
-    // Initialize OTA update
-    fancyLog.toSerial("Initializing OTA update storage", INFO);
-    if (!OTAManager::beginUpdate(firmwareSize)) {
-        fancyLog.toSerial("Failed to initialize storage for update", ERROR);
-        wifiClient.stop();
-        return false;
+    if (millis() - updateLastDataMillis > API_TIMEOUT) {
+        failUpdateDownload("Failed to find header end marker");
     }
+}
+
+void NetworkManager::pollUpdateDownload() {
+    unsigned long currentMillis = millis();
     
-    fancyLog.toSerial("Started firmware update process", INFO);
-    int totalRead = 0;
-    int lastProgressPercentage = -1; // Start with -1 to ensure first update is shown
-    unsigned long downloadTimeout = millis();
-    unsigned long lastProgressTime = millis();
-    
-    // Display initial update progress (0%)
-    display.showUpdateProgress(0);
-    
-    // Check if any data is available initially
-    if (!wifiClient.available()) {
-        fancyLog.toSerial("No data available after headers", WARNING);
-        delay(1000); // Wait a bit for data to become available
+    // The total timeout is checked in pollUpdate()
+    if (currentMillis - updateLastDataMillis > OTA_STALL_TIMEOUT) {
+        failUpdateDownload("Download stalled - no progress for " + String(OTA_STALL_TIMEOUT / 1000) + " seconds");
+        return;
     }
     
-    // Main download loop with timeout handling
-    while (totalRead < firmwareSize) {
-        // Check for timeout conditions
-        if (millis() - downloadTimeout > API_TIMEOUT * 3) {
-            fancyLog.toSerial("Download timeout - total timeout exceeded", WARNING);
-            OTAManager::abortUpdate();
-            wifiClient.stop();
-            return false;
+    // Move at most one chunk per loop iteration so sampling keeps its schedule
+    int chunkRead = 0;
+    while (chunkRead < OTA_CHUNK_SIZE && updateReceived < updateSize && otaClient.available()) {
+        uint8_t buffer[128];
+        int wanted = min((int)sizeof(buffer), min(OTA_CHUNK_SIZE - chunkRead, updateSize - updateReceived));
+        int bytesRead = otaClient.read(buffer, wanted);
+        
+        if (bytesRead <= 0) {
+            break;
         }
         
-        // Check for stalled download
-        if (millis() - lastProgressTime > 10000) { // 10 seconds without progress
-            fancyLog.toSerial("Download stalled - no progress for 10 seconds",  WARNING);
-            OTAManager::abortUpdate();
-            wifiClient.stop();
-            return false;
+        // Write the data to flash storage
+        int bytesWritten = OTAManager::write(buffer, bytesRead);
+        if (bytesWritten != bytesRead) {
+            updateFromSeed = false; // A flash error will not be fixed by another source
+            failUpdateDownload("Error writing firmware data: expected=" +
+                               String(bytesRead) + ", actual=" + String(bytesWritten));
+            return;
         }
         
-        // Handle data reading
-        if (wifiClient.available()) {
-            uint8_t buffer[128];
-            int bytesRead = wifiClient.read(buffer, sizeof(buffer));
-            
-            if (bytesRead <= 0) {
-                fancyLog.toSerial("Zero bytes read from client", WARNING);
-                delay(100);
-                continue;
-            }
-            
-            // Update the last progress time since we received data
-            lastProgressTime = millis();
-            
-            // Write the data to flash storage
-            int bytesWritten = OTAManager::write(buffer, bytesRead);
-            if (bytesWritten != bytesRead) {
-                fancyLog.toSerial("Error writing firmware data: expected=" +
-                                  String(bytesRead) + ", actual=" + String(bytesWritten));
-                OTAManager::abortUpdate();
-                wifiClient.stop();
-                return false;
-            }
-            
-            totalRead += bytesRead;
-            
-            // Calculate progress percentage
-            int progressPercentage = (totalRead * 100) / firmwareSize;
-            
-            // Update display only when percentage changes significantly
-            if (progressPercentage / 5 > lastProgressPercentage / 5) {
-                lastProgressPercentage = progressPercentage;
-                display.showUpdateProgress(progressPercentage);
-                fancyLog.toSerial("Downloaded: " + String(totalRead) + " bytes (" + String(progressPercentage) + "%)");
-            }
-        } else if (!wifiClient.connected()) {
-            // Connection closed prematurely
-            if (totalRead < firmwareSize) {
-                fancyLog.toSerial("Connection closed before download completed: " +
-                                 String(totalRead) + "/" + String(firmwareSize) + " bytes");
-                OTAManager::abortUpdate();
-                wifiClient.stop();
-                return false;
+        updateHasher.update(buffer, bytesRead);
+        chunkRead += bytesRead;
+        updateReceived += bytesRead;
+    }
+    
+    if (chunkRead > 0) {
+        if (currentMillis - updateLastDataMillis > OTA_STALL_REPORT_THRESHOLD) {
+            otaReport.stalls++;
+        }
+        updateLastDataMillis = currentMillis;
+        
+        // Update display only when percentage changes significantly
+        int progressPercentage = (int)(((long)updateReceived * 100) / updateSize);
+        if (progressPercentage / 5 > updateProgressPercentage / 5) {
+            // Milestones for the server are coarser than the display steps
+            if (progressPercentage / OTA_REPORT_STEP_PERCENTAGE > updateProgressPercentage / OTA_REPORT_STEP_PERCENTAGE) {
+                updateOTAReport("downloading");
             }
-            break; // Download completed and connection closed normally
-        } else {
-            // No data available but still connected, wait briefly
-            delay(10);
+            updateProgressPercentage = progressPercentage;
+            display.showUpdateProgressBar(progressPercentage);
+            fancyLog.toSerial("Downloaded: " + String(updateReceived) + " bytes (" + String(progressPercentage) + "%)");
         }
     }
     
-    // Close the WiFi client since we're done with it
-    wifiClient.stop();
+    if (updateReceived < updateSize) {
+        if (!otaClient.available() && !otaClient.connected()) {
+            failUpdateDownload("Connection closed before download completed: " +
+                               String(updateReceived) + "/" + String(updateSize) + " bytes");
+        }
+        return;
+    }
     
-    // Check if download was successful
-    if (totalRead < firmwareSize) {
-        fancyLog.toSerial("Download incomplete: " + String(totalRead) +
-                         "/" + String(firmwareSize) + " bytes received");
-        OTAManager::abortUpdate();
-        return false;
+    // Close the client since we're done with it
+    otaClient.stop();
+    
+    if (updateSha256.length() > 0 && !updateHasher.finishHex().equalsIgnoreCase(updateSha256)) {
+        seedAttempts = SEED_MAX_ATTEMPTS; // Never resume on top of a corrupt image
+        failUpdateDownload("Firmware hash mismatch, discarding image");
+        return;
     }
     
     fancyLog.toSerial("Finalizing update", INFO);
     if (!OTAManager::endUpdate()) {
+        updateState = UPDATE_IDLE;
         fancyLog.toSerial("Failed to finalize the update", ERROR);
+        otaReport.reason = "Failed to finalize the update";
+        updateOTAReport("failed");
+        return;
+    }
+    
+    fancyLog.toSerial("Firmware downloaded in " + String((currentMillis - updateStartMillis) / 1000) +
+                      "s, waiting for a quiet window to apply", INFO);
+    updateState = UPDATE_READY;
+    updateOTAReport("downloaded");
+}
+
+void NetworkManager::failUpdateDownload(const String& reason) {
+    fancyLog.toSerial(reason, ERROR);
+    otaClient.stop();
+    otaReport.reason = reason;
+    
+    if (updateFromSeed) {
+        otaReport.retries++;
+        // Resume from the same peer while it keeps making progress
+        seedAttempts++;
+        if (seedAttempts < SEED_MAX_ATTEMPTS && updateReceived > 0) {
+            fancyLog.toSerial("Resuming peer download at byte " + String(updateReceived), WARNING);
+            updateLastDataMillis = millis();
+            updateState = UPDATE_CONNECTING;
+            return;
+        }
+        
+        fancyLog.toSerial("Peer download failed, falling back to the update server", WARNING);
+        if (updateStorageOpen) {
+            OTAManager::abortUpdate();
+        }
+        updateFromSeed = false;
+        resetUpdateDownload();
+        updateOTAReport("downloading");
+        return;
+    }
+    
+    if (updateStorageOpen) {
+        OTAManager::abortUpdate();
+    }
+    updateState = UPDATE_IDLE;
+    updateOTAReport("failed");
+    display.showSadFace();
+}
+
+void NetworkManager::updateOTAReport(const String& result) {
+    otaReport.result = result;
+    otaReport.bytesDone = updateReceived;
+    otaReport.size = updateSize;
+    otaReport.elapsedMillis = millis() - updateStartMillis;
+    otaReport.fromSeed = updateFromSeed;
+    otaReport.pending = true;
+}
+
+bool NetworkManager::attachOTAReport(JsonDocument& jsonDoc) {
+    if (!otaReport.pending) {
         return false;
     }
     
-    fancyLog.toSerial("Firmware downloaded successfully!", INFO);
+    // One summary per upload, however many milestones passed since the last one
+    JsonObject ota = jsonDoc.createNestedObject("ota");
+    ota["version"] = otaReport.version;
+    ota["result"] = otaReport.result;
+    ota["bytesDone"] = otaReport.bytesDone;
+    ota["size"] = otaReport.size;
+    ota["elapsedMs"] = otaReport.elapsedMillis;
+    ota["bytesPerSecond"] = otaReport.elapsedMillis > 0 ? (long)otaReport.bytesDone * 1000L / (long)otaReport.elapsedMillis : 0L;
+    ota["stalls"] = otaReport.stalls;
+    ota["retries"] = otaReport.retries;
+    ota["source"] = otaReport.fromSeed ? "seed" : "server";
+    if (otaReport.reason.length() > 0) {
+        ota["reason"] = otaReport.reason;
+    }
+    return true;
+}
+
+void NetworkManager::applyPendingUpdate() {
+    if (updateState != UPDATE_READY) {
+        return;
+    }
+    
     fancyLog.toSerial("Applying update...", INFO);
     
+    // Only images verified against the manifest hash may later be served to peers
+    if (updateSha256.length() > 0) {
+        FirmwareSeeder::rememberImage(updateSize, updateSha256, latestFirmwareVersion);
+    }
+    
     // Show 100% update progress
     display.showUpdateProgress(100);
     
-    // Notify server about the update
-    StaticJsonDocument<256> statusDoc;
+    // Notify server about the update, with the final download figures
+    StaticJsonDocument<512> statusDoc;
     statusDoc["deviceId"] = DeviceIdentifier::getDeviceId();
     statusDoc["firmwareVersion"] = FIRMWARE_VERSION;
     statusDoc["modelType"] = MODEL_TYPE;
+    updateOTAReport("applying");
+    attachOTAReport(statusDoc);
     
     String statusData;
     serializeJson(statusDoc, statusData);
     fancyLog.toSerial("Sending update status to server", INFO);
-    sendHttpPostRequest(statusData, "/api/device/register");
+    sendHttpPostRequest(statusData, API_REGISTER_ROUTE);
     
-    // Give time to see the completion message before restart
-    delay(3000);
     fancyLog.toSerial("Restarting with new firmware", INFO);
     OTAManager::applyUpdate();  // This will restart the board
-    return true;
-} 
\ No newline at end of file
+}
@@ -3,28 +3,100 @@
 
 #include "../config/Config.h"
 #include "../network/OTAManager.h"
+#include "../network/FirmwareSeeder.h"
 #include "../display/DisplayManager.h"
 #include "../utils/FancyLog.h"
+#include "../utils/Sha256.h"
+
+// Background firmware download stages, advanced one step per pollUpdate() call
+enum UpdateState {
+  UPDATE_IDLE,
+  UPDATE_CONNECTING,
+  UPDATE_HEADERS,
+  UPDATE_DOWNLOADING,
+  UPDATE_READY // Downloaded, waiting for a quiet window to apply
+};
+
+// Rollout telemetry, collected during a download and piggybacked on the next regular upload
+struct OTAReport {
+  String version;
+  String result; // "downloading", "downloaded", "applying" or "failed"
+  String reason; // Last error, empty when none
+  int bytesDone;
+  int size;
+  unsigned long elapsedMillis;
+  int stalls;
+  int retries;
+  bool fromSeed;
+  bool pending; // Changed since the server last saw it
+};
 
 class NetworkManager {
   public:
     NetworkManager(FancyLog& fancyLog, OTAManager& otaManager, DisplayManager& display);
-    void begin();
+    void begin(); // Starts WiFi association without waiting for it
     bool connectWiFi();
     bool sendHttpPostRequest(String jsonPayload, String apiRoute);
     void checkForUpdates();
-    void pollOTA();
+    unsigned long getNextCheckHint() { return nextCheckHintSeconds; } // Seconds, 0 when the server sent none
+    void pollOTA(); // No-op unless the IDE OTA listener window is open
+    void openOTAWindow(unsigned long durationMillis = OTA_LISTENER_WINDOW);
+    void closeOTAWindow();
+    bool isOTAWindowOpen() { return otaWindowOpen; }
+    bool attachOTAReport(JsonDocument& jsonDoc); // Adds an "ota" object when there is news to report
+    void clearOTAReport() { otaReport.pending = false; } // Call once the upload carrying it succeeded
+    void pollUpdate(); // Moves a pending firmware download forward by one chunk
+    bool isUpdateInProgress() { return updateState != UPDATE_IDLE; }
+    bool isUpdateReady() { return updateState == UPDATE_READY; }
+    void applyPendingUpdate(); // Restarts the board, call only in a quiet window
     bool isConnected() { return WiFi.status() == WL_CONNECTED; }
+    bool isConnecting() { return !isConnected() && millis() - connectStartMillis < WIFI_TIMEOUT; }
+    void parkRadio(); // Disconnects until wakeRadio(), a blocking connectWiFi() also wakes it
+    void wakeRadio(); // Starts association without waiting for it
+    bool isRadioParked() { return radioParked; }
+    long getRSSI() { return isConnected() ? WiFi.RSSI() : 0; } // dBm, 0 when not associated
 
   private:
     FancyLog& fancyLog;
     OTAManager& otaManager;
     DisplayManager& display;
     WiFiClient wifiClient;
+    WiFiClient otaClient; // Separate socket so uploads can run while a download is pending
     bool updateAvailable;
     String latestFirmwareVersion;
+    UpdateState updateState;
+    String updateUrl;
+    int updateSize;
+    int updateReceived;
+    int updateProgressPercentage;
+    unsigned long updateStartMillis;
+    unsigned long updateLastDataMillis;
+    bool updateStorageOpen;
+    String updateSha256; // Expected image hash from the manifest, empty when not provided
+    Sha256 updateHasher;
+    bool updateFromSeed;
+    String seedHost;
+    int seedPort;
+    int seedAttempts;
+    unsigned long nextCheckHintSeconds;
+    bool otaWindowOpen;
+    unsigned long otaWindowStart;
+    unsigned long otaWindowLength;
+    unsigned long otaPollCount;
+    unsigned long otaPollMicros;
+    unsigned long otaPollMaxMicros;
+    OTAReport otaReport;
+    unsigned long connectStartMillis;
+    bool radioParked;
+    void updateOTAReport(const String& result);
     bool handleUpdateResponse(String& response);
-    bool downloadAndApplyUpdate(String& downloadUrl, int firmwareSize);
+    void syncClock(const String& dateHeader); // Sets TimeLib from a "Date:" header line
+    void startUpdateDownload(String& downloadUrl, int firmwareSize);
+    void resetUpdateDownload();
+    void pollUpdateConnect();
+    void pollUpdateHeaders();
+    void pollUpdateDownload();
+    void failUpdateDownload(const String& reason);
 };
 
 #endif // NETWORK_MANAGER_H 
\ No newline at end of file
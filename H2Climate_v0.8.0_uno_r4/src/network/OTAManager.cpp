@@ -11,6 +11,10 @@ void OTAManager::poll() {
     ArduinoOTA.poll();
 }
 
+void OTAManager::end() {
+    ArduinoOTA.end();
+}
+
 bool OTAManager::beginUpdate(int size) {
     return InternalStorage.open(size);
 }
@@ -8,6 +8,7 @@ class OTAManager {
     OTAManager();
     static void begin(IPAddress localIP, const char* ssid, const char* password);
     static void poll();
+    static void end();
     static bool beginUpdate(int size);
     static size_t write(const uint8_t* data, size_t len);
     static bool endUpdate();
@@ -0,0 +1,101 @@
+#include "SeedRequest.h"
+
+SeedRequest::SeedRequest(int imageSize)
+    : imageSize(imageSize), requestLineSeen(false), pathMatches(false), versionMatches(true), ranged(false),
+      rangeValid(true), complete(false), rangeStart(0), rangeEnd(imageSize - 1) {}
+
+//¤=======================================================================================¤
+
+bool SeedRequest::addLine(const String& line) {
+    if (complete) {
+        return true;
+    }
+
+    // Request line, e.g. "GET /firmware?version=V0.9.0 HTTP/1.1"
+    if (!requestLineSeen) {
+        requestLineSeen = true;
+        pathMatches = line.startsWith("GET " + String(SEED_ROUTE));
+        // The value runs to the next parameter or the protocol, V0.9.01 must not pass for V0.9.0
+        int versionIndex = line.indexOf("version=");
+        if (versionIndex >= 0) {
+            int valueStart = versionIndex + 8;
+            int valueEnd = line.indexOf('&', valueStart);
+            int space = line.indexOf(' ', valueStart);
+            if (valueEnd < 0 || (space >= 0 && space < valueEnd)) {
+                valueEnd = space;
+            }
+            String version = valueEnd < 0 ? line.substring(valueStart) : line.substring(valueStart, valueEnd);
+            version.trim();
+            versionMatches = version == FIRMWARE_VERSION;
+        }
+        return false;
+    }
+
+    if (line == "\r" || line.length() == 0) {
+        complete = true;
+        return true;
+    }
+
+    // Headers, only Range is of interest and header names are case-insensitive
+    int colon = line.indexOf(':');
+    if (colon > 0 && line.substring(0, colon).equalsIgnoreCase("Range")) {
+        parseRange(line.substring(colon + 1));
+    }
+    return false;
+}
+
+int SeedRequest::getStatus() {
+    if (!pathMatches || !versionMatches) {
+        return 404;
+    }
+    if (!rangeValid || rangeStart < 0 || rangeStart > rangeEnd) {
+        return 416;
+    }
+    return ranged ? 206 : 200;
+}
+
+String SeedRequest::getResponseHeader() {
+    int status = getStatus();
+    if (status == 404 || status == 416) {
+        String reason = status == 404 ? "404 Not Found" : "416 Range Not Satisfiable";
+        return "HTTP/1.1 " + reason + "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    }
+
+    String header = ranged ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n";
+    header += "Content-Type: application/octet-stream\r\n";
+    header += "Content-Length: " + String(rangeEnd - rangeStart + 1) + "\r\n";
+    if (ranged) {
+        header += "Content-Range: bytes " + String(rangeStart) + "-" + String(rangeEnd) + "/" + String(imageSize) + "\r\n";
+    }
+    header += "Connection: close\r\n\r\n";
+    return header;
+}
+
+//¤=======================================================================================¤
+
+void SeedRequest::parseRange(String value) {
+    value.trim();
+    int dash = value.indexOf('-');
+    if (!value.startsWith("bytes=") || dash < 0) {
+        rangeValid = false;
+        return;
+    }
+
+    ranged = true;
+    String startPart = value.substring(6, dash);
+    String endPart = value.substring(dash + 1);
+    startPart.trim();
+    endPart.trim();
+
+    if (startPart.length() == 0) {
+        // Suffix range, the last N bytes
+        int suffix = endPart.toInt();
+        rangeValid = suffix > 0;
+        rangeStart = max(imageSize - suffix, 0);
+        rangeEnd = imageSize - 1;
+        return;
+    }
+
+    rangeStart = startPart.toInt();
+    rangeEnd = endPart.length() > 0 ? min((int)endPart.toInt(), imageSize - 1) : imageSize - 1;
+}
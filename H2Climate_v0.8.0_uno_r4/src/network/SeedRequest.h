@@ -0,0 +1,32 @@
+#ifndef SEED_REQUEST_H
+#define SEED_REQUEST_H
+
+#include "../config/Config.h"
+
+// Parses a peer's firmware request one line at a time, so headers that arrive
+// after the first TCP segment are still seen, and builds the matching response
+// header. Kept free of WiFi so the host tests can drive it.
+class SeedRequest {
+  public:
+    SeedRequest(int imageSize);
+    bool addLine(const String& line); // True once the blank line after the headers arrived
+    bool isComplete() { return complete; }
+    int getStatus(); // 200, 206, 404 or 416
+    int getRangeStart() { return rangeStart; }
+    int getRangeEnd() { return rangeEnd; } // Inclusive
+    String getResponseHeader(); // Status line and headers, ends with the blank line
+
+  private:
+    int imageSize;
+    bool requestLineSeen;
+    bool pathMatches;
+    bool versionMatches;
+    bool ranged;
+    bool rangeValid;
+    bool complete;
+    int rangeStart;
+    int rangeEnd;
+    void parseRange(String value);
+};
+
+#endif // SEED_REQUEST_H
@@ -0,0 +1,113 @@
+#include "UpdateScheduler.h"
+
+const char* const HTTP_MONTHS = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+time_t parseHttpDate(const char* value) {
+    // The weekday is optional for us, skip past it
+    const char* comma = strchr(value, ',');
+    if (comma != nullptr) {
+        value = comma + 1;
+    }
+
+    int day, year, hours, minutes, seconds;
+    char monthName[4];
+    if (sscanf(value, " %d %3s %d %d:%d:%d", &day, monthName, &year, &hours, &minutes, &seconds) != 6) {
+        return 0;
+    }
+    const char* found = strstr(HTTP_MONTHS, monthName);
+    if (strlen(monthName) != 3 || found == nullptr || (found - HTTP_MONTHS) % 3 != 0) {
+        return 0;
+    }
+    int month = (found - HTTP_MONTHS) / 3 + 1;
+
+    // Days since 1970-01-01 in the proleptic Gregorian calendar, years start in March
+    int y = year - (month <= 2 ? 1 : 0);
+    int era = y / 400;
+    int yearOfEra = y - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long days = era * 146097L + yearOfEra * 365L + yearOfEra / 4 - yearOfEra / 100 + dayOfYear - 719468L;
+
+    time_t result = (time_t)days * 86400 + hours * 3600L + minutes * 60L + seconds;
+    return result >= MIN_VALID_EPOCH ? result : 0;
+}
+
+UpdateScheduler::UpdateScheduler(int windowStartHour, int windowEndHour)
+    : windowStartHour(windowStartHour), windowEndHour(windowEndHour), deviceHash(0), anchorMillis(0), delayMillis(0) {}
+
+//¤=======================================================================================¤
+
+void UpdateScheduler::begin(const String& deviceId, unsigned long currentMillis) {
+    deviceHash = hashDeviceId(deviceId);
+
+    // Spread the first check after boot instead of checking right away
+    scheduleIn(currentMillis, deviceHash % UPDATE_CHECK_BOOT_SPREAD);
+}
+
+//¤=======================================================================================¤
+
+bool UpdateScheduler::isDue(unsigned long currentMillis, time_t wallClock) {
+    if (currentMillis - anchorMillis < delayMillis) {
+        return false;
+    }
+
+    // Postpone to the start of the maintenance window, keeping the device offset
+    if (wallClock >= MIN_VALID_EPOCH && !isInsideWindow(hour(wallClock))) {
+        scheduleIn(currentMillis, secondsUntilWindow(wallClock) * 1000UL + deviceHash % UPDATE_CHECK_BOOT_SPREAD);
+        return false;
+    }
+
+    return true;
+}
+
+//¤=======================================================================================¤
+
+void UpdateScheduler::onCheckCompleted(unsigned long currentMillis, unsigned long hintSeconds) {
+    if (hintSeconds > 0) {
+        // Honour the server hint, with a tenth of it as jitter so the hint itself does not align the fleet
+        hintSeconds = min(hintSeconds, UPDATE_CHECK_MAX_HINT);
+        unsigned long hintMillis = hintSeconds * 1000UL;
+        scheduleIn(currentMillis, hintMillis + deviceHash % (hintMillis / 10 + 1));
+        return;
+    }
+
+    scheduleIn(currentMillis, CHECK_INTERVAL + deviceHash % UPDATE_CHECK_JITTER);
+}
+
+unsigned long UpdateScheduler::getMillisUntilDue(unsigned long currentMillis) {
+    unsigned long elapsed = currentMillis - anchorMillis;
+    return elapsed >= delayMillis ? 0 : delayMillis - elapsed;
+}
+
+//¤=======================================================================================¤
+
+void UpdateScheduler::scheduleIn(unsigned long currentMillis, unsigned long delay) {
+    anchorMillis = currentMillis;
+    delayMillis = delay;
+}
+
+uint32_t UpdateScheduler::hashDeviceId(const String& deviceId) {
+    // FNV-1a, stable across reboots and firmware versions
+    uint32_t hash = 2166136261UL;
+    for (unsigned int i = 0; i < deviceId.length(); i++) {
+        hash ^= (uint8_t)deviceId[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+bool UpdateScheduler::isInsideWindow(int hour) {
+    if (windowStartHour == windowEndHour) {
+        return true;
+    }
+    if (windowStartHour < windowEndHour) {
+        return hour >= windowStartHour && hour < windowEndHour;
+    }
+    // Window wraps around midnight, e.g. 22-4
+    return hour >= windowStartHour || hour < windowEndHour;
+}
+
+unsigned long UpdateScheduler::secondsUntilWindow(time_t wallClock) {
+    unsigned long secondsToday = wallClock % 86400UL;
+    unsigned long windowStart = windowStartHour * 3600UL;
+    return windowStart > secondsToday ? windowStart - secondsToday : 86400UL - secondsToday + windowStart;
+}
@@ -0,0 +1,36 @@
+#ifndef UPDATE_SCHEDULER_H
+#define UPDATE_SCHEDULER_H
+
+#include "../config/Config.h"
+
+// Anything below this is seconds since boot rather than a real date (2020-01-01)
+const time_t MIN_VALID_EPOCH = 1577836800;
+
+// Unix time from an HTTP Date header value ("Sun, 18 Oct 2026 21:19:25 GMT"), 0 when it does not parse
+time_t parseHttpDate(const char* value);
+
+// Decides when the next firmware check is due. The schedule is offset by a
+// deterministic per-device jitter so a fleet that powers up together does not
+// hit the update server in the same second.
+class UpdateScheduler {
+  public:
+    // Maintenance window in UTC hours [start, end), equal hours disable it
+    UpdateScheduler(int windowStartHour = UPDATE_WINDOW_START_HOUR, int windowEndHour = UPDATE_WINDOW_END_HOUR);
+    void begin(const String& deviceId, unsigned long currentMillis);
+    bool isDue(unsigned long currentMillis, time_t wallClock);
+    void onCheckCompleted(unsigned long currentMillis, unsigned long hintSeconds);
+    unsigned long getMillisUntilDue(unsigned long currentMillis);
+
+  private:
+    int windowStartHour;
+    int windowEndHour;
+    uint32_t deviceHash;
+    unsigned long anchorMillis;
+    unsigned long delayMillis;
+    void scheduleIn(unsigned long currentMillis, unsigned long delay);
+    static uint32_t hashDeviceId(const String& deviceId);
+    bool isInsideWindow(int hour);
+    unsigned long secondsUntilWindow(time_t wallClock);
+};
+
+#endif // UPDATE_SCHEDULER_H
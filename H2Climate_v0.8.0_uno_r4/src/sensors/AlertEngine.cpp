@@ -0,0 +1,123 @@
+#include "AlertEngine.h"
+
+const char* getAlertConditionName(AlertCondition condition) {
+    switch (condition) {
+        case ALERT_ABOVE: return "above";
+        case ALERT_BELOW: return "below";
+        case ALERT_RISING: return "rising";
+        case ALERT_FALLING: return "falling";
+        default: return "unknown";
+    }
+}
+
+AlertEngine::AlertEngine() {
+    for (int i = 0; i < MAX_ALERT_RULES; i++) {
+        clearRule(i);
+    }
+
+    setRule(0, { true, CHANNEL_TEMPERATURE, ALERT_ABOVE, ALERT_TEMPERATURE_HIGH, ALERT_TEMPERATURE_HYSTERESIS, ALERT_MIN_DURATION });
+    setRule(1, { true, CHANNEL_TEMPERATURE, ALERT_BELOW, ALERT_TEMPERATURE_LOW, ALERT_TEMPERATURE_HYSTERESIS, ALERT_MIN_DURATION });
+    setRule(2, { true, CHANNEL_HUMIDITY, ALERT_ABOVE, ALERT_HUMIDITY_HIGH, ALERT_HUMIDITY_HYSTERESIS, ALERT_MIN_DURATION });
+    setRule(3, { true, CHANNEL_TEMPERATURE, ALERT_FALLING, ALERT_TEMPERATURE_RATE, ALERT_RATE_HYSTERESIS, ALERT_MIN_DURATION });
+}
+
+//¤=======================================================================================¤
+
+bool AlertEngine::setRule(int index, const AlertRule& rule) {
+    if (index < 0 || index >= MAX_ALERT_RULES || rule.channel >= SENSOR_CHANNEL_COUNT) {
+        return false;
+    }
+    rules[index] = rule;
+    resetState(index);
+    return true;
+}
+
+void AlertEngine::clearRule(int index) {
+    if (index < 0 || index >= MAX_ALERT_RULES) {
+        return;
+    }
+    rules[index] = { false, CHANNEL_TEMPERATURE, ALERT_ABOVE, 0.0f, 0.0f, 0 };
+    resetState(index);
+}
+
+uint16_t AlertEngine::evaluate(const SensorReading& reading, unsigned long currentMillis) {
+    uint16_t changed = 0;
+
+    for (int i = 0; i < MAX_ALERT_RULES; i++) {
+        const AlertRule& rule = rules[i];
+        RuleState& state = states[i];
+        if (!rule.enabled || !reading.has(rule.channel)) {
+            continue;
+        }
+
+        float value = reading.values[rule.channel];
+        float measure = value;
+
+        // Rate rules compare against the previous sample of the same channel
+        if (rule.condition == ALERT_RISING || rule.condition == ALERT_FALLING) {
+            bool hadPrevious = state.hasPrevious;
+            float minutes = (currentMillis - state.previousMillis) / 60000.0f;
+            measure = hadPrevious && minutes > 0.0f ? (value - state.previousValue) / minutes : 0.0f;
+
+            state.hasPrevious = true;
+            state.previousValue = value;
+            state.previousMillis = currentMillis;
+            if (!hadPrevious) {
+                continue;
+            }
+        }
+        state.lastMeasure = measure;
+
+        // Only flip once the condition has disagreed with the state for minDuration
+        if (isTriggered(rule, state.active, measure) == state.active) {
+            state.pending = false;
+            continue;
+        }
+        if (!state.pending) {
+            state.pending = true;
+            state.pendingSince = currentMillis;
+        }
+        if (currentMillis - state.pendingSince >= rule.minDuration) {
+            state.active = !state.active;
+            state.pending = false;
+            changed |= (1 << i);
+        }
+    }
+
+    return changed;
+}
+
+bool AlertEngine::isAnyActive() {
+    for (int i = 0; i < MAX_ALERT_RULES; i++) {
+        if (rules[i].enabled && states[i].active) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//¤=======================================================================================¤
+
+void AlertEngine::resetState(int index) {
+    RuleState& state = states[index];
+    state.active = false;
+    state.pending = false;
+    state.pendingSince = 0;
+    state.hasPrevious = false;
+    state.previousValue = 0.0f;
+    state.previousMillis = 0;
+    state.lastMeasure = 0.0f;
+}
+
+bool AlertEngine::isTriggered(const AlertRule& rule, bool active, float measure) {
+    // An active alert holds until the measure is back past the threshold by the hysteresis
+    float margin = active ? rule.hysteresis : 0.0f;
+
+    switch (rule.condition) {
+        case ALERT_ABOVE: return measure > rule.threshold - margin;
+        case ALERT_BELOW: return measure < rule.threshold + margin;
+        case ALERT_RISING: return measure > rule.threshold - margin;
+        case ALERT_FALLING: return -measure > rule.threshold - margin;
+        default: return false;
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef ALERT_ENGINE_H
+#define ALERT_ENGINE_H
+
+#include "../config/Config.h"
+#include "../sensors/SensorDriver.h"
+
+static_assert(MAX_ALERT_RULES <= 16, "evaluate() reports one bit per rule in a uint16_t");
+
+enum AlertCondition {
+  ALERT_ABOVE,
+  ALERT_BELOW,
+  ALERT_RISING, // Rate of change in units per minute
+  ALERT_FALLING
+};
+
+struct AlertRule {
+  bool enabled;
+  SensorChannel channel;
+  AlertCondition condition;
+  float threshold;
+  float hysteresis; // How far back past the threshold the value has to go before the alert clears
+  unsigned long minDuration; // How long the condition has to hold before the state changes
+};
+
+const char* getAlertConditionName(AlertCondition condition); // Key used in the JSON payload and serial commands
+
+// Per-sample rule evaluation with hysteresis and minimum durations. Rules live
+// in a fixed table, so evaluation is O(rules) and never allocates.
+class AlertEngine {
+  public:
+    AlertEngine(); // Loads the default rules from Config.h
+    bool setRule(int index, const AlertRule& rule); // Replaces a rule and resets its state
+    void clearRule(int index);
+    const AlertRule& getRule(int index) { return rules[index]; }
+    uint16_t evaluate(const SensorReading& reading, unsigned long currentMillis); // Returns a bit per rule that changed state
+    bool isActive(int index) { return states[index].active; }
+    bool isAnyActive();
+    float getLastMeasure(int index) { return states[index].lastMeasure; } // Value or rate at the last evaluation
+
+  private:
+    struct RuleState {
+      bool active;
+      bool pending; // The condition disagrees with the state, waiting for minDuration
+      unsigned long pendingSince;
+      bool hasPrevious; // Rate rules need a previous sample
+      float previousValue;
+      unsigned long previousMillis;
+      float lastMeasure;
+    };
+    AlertRule rules[MAX_ALERT_RULES];
+    RuleState states[MAX_ALERT_RULES];
+    void resetState(int index);
+    bool isTriggered(const AlertRule& rule, bool active, float measure);
+};
+
+#endif // ALERT_ENGINE_H
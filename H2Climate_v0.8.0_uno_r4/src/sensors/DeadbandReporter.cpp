@@ -0,0 +1,96 @@
+#include "DeadbandReporter.h"
+
+DeadbandReporter::DeadbandReporter()
+    : lastReportedMask(0), lastReportMillis(0), heartbeatInterval(REPORT_HEARTBEAT_INTERVAL), reportedOnce(false),
+      evaluated(0), suppressed(0), suppressedSinceReport(0), forced(0) {
+    for (int channel = 0; channel < SENSOR_CHANNEL_COUNT; channel++) {
+        history[channel].count = 0;
+    }
+}
+
+//¤=======================================================================================¤
+
+ReportReason DeadbandReporter::evaluate(const WindowSummary& summary, bool force, unsigned long currentMillis) {
+    evaluated++;
+
+    if (!ENABLE_DEADBAND || !reportedOnce || summary.channelMask != lastReportedMask) {
+        return REPORT_CHANGED;
+    }
+
+    for (int channel = 0; channel < SENSOR_CHANNEL_COUNT; channel++) {
+        if ((summary.channelMask & (1 << channel)) &&
+            isOutsideBand(channel, summary.channels[channel], summary.startTimestamp, summary.endTimestamp)) {
+            return REPORT_CHANGED;
+        }
+    }
+
+    if (currentMillis - lastReportMillis >= heartbeatInterval) {
+        return REPORT_HEARTBEAT;
+    }
+
+    // Counted apart, a forced window says nothing about how well the deadband works
+    if (force) {
+        forced++;
+        return REPORT_FORCED;
+    }
+
+    suppressed++;
+    suppressedSinceReport++;
+    return REPORT_SUPPRESSED;
+}
+
+void DeadbandReporter::onReported(const WindowSummary& summary, unsigned long currentMillis) {
+    for (int channel = 0; channel < SENSOR_CHANNEL_COUNT; channel++) {
+        ChannelHistory& point = history[channel];
+        if (!(summary.channelMask & (1 << channel))) {
+            point.count = 0; // A channel that drops out starts over when it comes back
+            continue;
+        }
+
+        point.previousValue = point.lastValue;
+        point.previousTimestamp = point.lastTimestamp;
+        point.lastValue = summary.channels[channel].mean;
+        point.lastTimestamp = summary.endTimestamp;
+        if (point.count < 2) {
+            point.count++;
+        }
+    }
+    lastReportedMask = summary.channelMask;
+    lastReportMillis = currentMillis;
+    reportedOnce = true;
+    suppressedSinceReport = 0;
+}
+
+float DeadbandReporter::predict(SensorChannel channel, time_t timestamp) {
+    ChannelHistory& point = history[channel];
+    if (REPORT_PREDICTOR == PREDICTOR_HOLD || point.count < 2 || point.lastTimestamp == point.previousTimestamp) {
+        return point.lastValue;
+    }
+
+    // Extrapolate the line through the last two uploaded points
+    float slope = (point.lastValue - point.previousValue) / (float)(point.lastTimestamp - point.previousTimestamp);
+    return point.lastValue + slope * (float)(timestamp - point.lastTimestamp);
+}
+
+float DeadbandReporter::getSuppressionRatio() {
+    if (evaluated == 0) {
+        return 0.0f;
+    }
+    return (float)suppressed / evaluated;
+}
+
+//¤=======================================================================================¤
+
+bool DeadbandReporter::isOutsideBand(int channel, const ChannelSummary& stats, time_t startTimestamp, time_t endTimestamp) {
+    float deadband = CHANNEL_DEADBAND[channel];
+    float predictedEnd = predict((SensorChannel)channel, endTimestamp);
+    if (fabsf(stats.mean - predictedEnd) > deadband) {
+        return true;
+    }
+
+    // The extremes fall somewhere in the window, the prediction is a line over it
+    float predictedStart = predict((SensorChannel)channel, startTimestamp);
+    float low = min(predictedStart, predictedEnd) - deadband;
+    float high = max(predictedStart, predictedEnd) + deadband;
+    return stats.min < low || stats.max > high;
+}
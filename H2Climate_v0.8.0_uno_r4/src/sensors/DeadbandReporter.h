@@ -0,0 +1,53 @@
+#ifndef DEADBAND_REPORTER_H
+#define DEADBAND_REPORTER_H
+
+#include "../config/Config.h"
+#include "../sensors/SensorDriver.h"
+#include "../sensors/WindowAggregator.h"
+
+enum ReportReason {
+  REPORT_SUPPRESSED, // Within the deadband, nothing to send
+  REPORT_CHANGED, // A channel left its deadband or appeared/disappeared
+  REPORT_HEARTBEAT, // Nothing changed, but the heartbeat interval has passed
+  REPORT_FORCED // Within the deadband, but the caller needs an upload, e.g. for a policy change
+};
+
+// Change-based reporting. The device and the server run the same predictor over
+// the uploaded values, and values are only sent when they are further than the
+// deadband from the prediction, or when the heartbeat interval is up. The window
+// mean and its extremes are all checked, so the server can rebuild every
+// suppressed sample within the deadband.
+class DeadbandReporter {
+  public:
+    DeadbandReporter();
+    ReportReason evaluate(const WindowSummary& summary, bool force, unsigned long currentMillis);
+    void onReported(const WindowSummary& summary, unsigned long currentMillis); // Call after a successful upload
+    float predict(SensorChannel channel, time_t timestamp); // What the server assumes when nothing is sent
+    unsigned long getSuppressedSinceReport() { return suppressedSinceReport; }
+    unsigned long getForcedCount() { return forced; } // Windows sent only because the caller forced them, since boot
+    float getSuppressionRatio(); // Suppressed share of all evaluated windows since boot
+    void setHeartbeatInterval(unsigned long interval) { heartbeatInterval = interval; }
+    unsigned long getHeartbeatInterval() { return heartbeatInterval; }
+
+  private:
+    // The last two uploaded points per channel, in Unix time so both sides agree
+    struct ChannelHistory {
+      uint8_t count;
+      float previousValue;
+      time_t previousTimestamp;
+      float lastValue;
+      time_t lastTimestamp;
+    };
+    ChannelHistory history[SENSOR_CHANNEL_COUNT];
+    uint16_t lastReportedMask;
+    unsigned long lastReportMillis;
+    unsigned long heartbeatInterval;
+    bool reportedOnce;
+    unsigned long evaluated;
+    unsigned long suppressed;
+    unsigned long suppressedSinceReport;
+    unsigned long forced;
+    bool isOutsideBand(int channel, const ChannelSummary& stats, time_t startTimestamp, time_t endTimestamp);
+};
+
+#endif // DEADBAND_REPORTER_H
@@ -0,0 +1,170 @@
+#include "DerivedChannels.h"
+
+// Magnus saturation vapour pressure 6.112 * exp(17.62 * T / (243.12 + T)) in hPa,
+// one entry per °C from -40 to 80. Interpolating linearly replaces expf/logf.
+const int SVP_TABLE_MIN = -40;
+const int SVP_TABLE_MAX = 80;
+const float SVP_TABLE[SVP_TABLE_MAX - SVP_TABLE_MIN + 1] = {
+    0.19021, 0.21092, 0.23364, 0.25855, 0.28584, 0.31571, 0.34836, 0.38403,
+    0.42297, 0.46543, 0.51169, 0.56205, 0.61683, 0.67636, 0.74102, 0.81117,
+    0.88723, 0.96964, 1.0588, 1.1553, 1.2597, 1.3723, 1.4939, 1.6251,
+    1.7665, 1.9187, 2.0826, 2.2589, 2.4483, 2.6518, 2.8703, 3.1047,
+    3.3559, 3.6251, 3.9134, 4.2218, 4.5517, 4.9043, 5.2809, 5.683,
+    6.112, 6.5695, 7.057, 7.5763, 8.1292, 8.7174, 9.343, 10.008,
+    10.714, 11.464, 12.26, 13.105, 14, 14.948, 15.953, 17.017,
+    18.142, 19.333, 20.591, 21.921, 23.326, 24.809, 26.374, 28.025,
+    29.766, 31.601, 33.533, 35.569, 37.711, 39.966, 42.337, 44.83,
+    47.45, 50.203, 53.094, 56.128, 59.313, 62.653, 66.156, 69.827,
+    73.675, 77.704, 81.924, 86.341, 90.963, 95.797, 100.85, 106.14,
+    111.66, 117.43, 123.45, 129.74, 136.3, 143.15, 150.29, 157.74,
+    165.5, 173.59, 182.02, 190.8, 199.93, 209.44, 219.34, 229.63,
+    240.34, 251.47, 263.04, 275.06, 287.54, 300.51, 313.98, 327.95,
+    342.46, 357.51, 373.11, 389.3, 406.08, 423.47, 441.49, 460.15,
+    479.49
+};
+const int SVP_TABLE_LAST = SVP_TABLE_MAX - SVP_TABLE_MIN;
+
+void addDerivedChannels(SensorReading& reading) {
+    if (!reading.has(CHANNEL_TEMPERATURE) || !reading.has(CHANNEL_HUMIDITY)) {
+        return;
+    }
+
+    float temperature = reading.values[CHANNEL_TEMPERATURE];
+    float humidity = reading.values[CHANNEL_HUMIDITY];
+
+    float dew = dewPoint(temperature, humidity);
+    if (ENABLE_DEW_POINT && !isnan(dew)) {
+        reading.set(CHANNEL_DEW_POINT, dew);
+    }
+    if (ENABLE_HEAT_INDEX) {
+        reading.set(CHANNEL_HEAT_INDEX, heatIndex(temperature, humidity));
+    }
+    if (ENABLE_ABSOLUTE_HUMIDITY) {
+        reading.set(CHANNEL_ABSOLUTE_HUMIDITY, absoluteHumidity(temperature, humidity));
+    }
+    float pmv, ppd;
+    if (ENABLE_COMFORT_INDEX && thermalComfort(temperature, humidity, pmv, ppd)) {
+        reading.set(CHANNEL_PMV, pmv);
+        reading.set(CHANNEL_PPD, ppd);
+    }
+}
+
+//¤=======================================================================================¤
+
+float saturationVaporPressure(float temperature) {
+    float position = constrain(temperature, (float)SVP_TABLE_MIN, (float)SVP_TABLE_MAX) - SVP_TABLE_MIN;
+    int index = min((int)position, SVP_TABLE_LAST - 1);
+    float fraction = position - index;
+    return SVP_TABLE[index] + (SVP_TABLE[index + 1] - SVP_TABLE[index]) * fraction;
+}
+
+float dewPoint(float temperature, float humidity) {
+    if (humidity >= 100.0f) {
+        return temperature;
+    }
+
+    // Actual vapour pressure, then find the temperature where it saturates
+    float vaporPressure = saturationVaporPressure(temperature) * max(humidity, 0.0f) / 100.0f;
+    if (vaporPressure <= SVP_TABLE[0]) {
+        // Cold and dry air saturates below the table, invert Magnus directly
+        if (vaporPressure <= 0.0f) {
+            return NAN;
+        }
+        float gamma = logf(vaporPressure / 6.112f);
+        return 243.12f * gamma / (17.62f - gamma);
+    }
+
+    int low = 0;
+    int high = SVP_TABLE_LAST;
+    while (high - low > 1) {
+        int middle = (low + high) / 2;
+        if (SVP_TABLE[middle] <= vaporPressure) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    float fraction = (vaporPressure - SVP_TABLE[low]) / (SVP_TABLE[high] - SVP_TABLE[low]);
+    return SVP_TABLE_MIN + low + min(fraction, 1.0f);
+}
+
+float heatIndex(float temperature, float humidity) {
+    // The NOAA regression works in Fahrenheit
+    float t = temperature * 1.8f + 32.0f;
+    float rh = humidity;
+
+    float index = 0.5f * (t + 61.0f + (t - 68.0f) * 1.2f + rh * 0.094f);
+    if ((index + t) / 2.0f >= 80.0f) {
+        index = -42.379f + 2.04901523f * t + 10.14333127f * rh - 0.22475541f * t * rh
+                - 0.00683783f * t * t - 0.05481717f * rh * rh + 0.00122874f * t * t * rh
+                + 0.00085282f * t * rh * rh - 0.00000199f * t * t * rh * rh;
+
+        if (rh < 13.0f && t >= 80.0f && t <= 112.0f) {
+            index -= ((13.0f - rh) / 4.0f) * sqrtf((17.0f - fabsf(t - 95.0f)) / 17.0f);
+        } else if (rh > 85.0f && t >= 80.0f && t <= 87.0f) {
+            index += ((rh - 85.0f) / 10.0f) * ((87.0f - t) / 5.0f);
+        }
+    }
+
+    return (index - 32.0f) / 1.8f;
+}
+
+float absoluteHumidity(float temperature, float humidity) {
+    // Ideal gas law for water vapour, 216.68 = 100 Pa/hPa * 1000 g/kg / 461.5 J/(kg K)
+    float vaporPressure = saturationVaporPressure(temperature) * humidity / 100.0f;
+    return 216.68f * vaporPressure / (temperature + 273.15f);
+}
+
+bool thermalComfort(float temperature, float humidity, float& pmv, float& ppd, int* iterations) {
+    // Follows the ISO 7730 Annex D reference code, with mean radiant temperature = air temperature
+    float vaporPressure = saturationVaporPressure(temperature) * humidity; // Pa, the table is in hPa
+    float clothingInsulation = 0.155f * COMFORT_CLOTHING; // m²K/W
+    float metabolism = COMFORT_METABOLIC_RATE * 58.15f; // W/m², no external work
+    float clothingArea = clothingInsulation <= 0.078f ? 1.0f + 1.29f * clothingInsulation : 1.05f + 0.645f * clothingInsulation;
+    float forcedConvection = 12.1f * sqrtf(COMFORT_AIR_VELOCITY);
+    float airKelvin = temperature + 273.0f;
+    float radiantKelvin = airKelvin;
+
+    float p1 = clothingInsulation * clothingArea;
+    float p2 = p1 * 3.96f;
+    float p3 = p1 * 100.0f;
+    float p4 = p1 * airKelvin;
+    float radiant = radiantKelvin / 100.0f;
+    float p5 = 308.7f - 0.028f * metabolism + p2 * radiant * radiant * radiant * radiant;
+
+    // Solve the clothing surface temperature, scaled by 1/100, by damped fixed-point iteration
+    float clothingKelvin = airKelvin + (35.5f - temperature) / (3.5f * clothingInsulation + 0.1f);
+    float xn = clothingKelvin / 100.0f;
+    float xf = clothingKelvin / 50.0f;
+    float convection = forcedConvection;
+    int count = 0;
+    while (fabsf(xn - xf) > 0.00015f) {
+        if (count >= COMFORT_MAX_ITERATIONS) {
+            return false;
+        }
+        xf = (xf + xn) / 2.0f;
+        float naturalConvection = 2.38f * sqrtf(sqrtf(fabsf(100.0f * xf - airKelvin)));
+        convection = max(forcedConvection, naturalConvection);
+        xn = (p5 + p4 * convection - p2 * xf * xf * xf * xf) / (100.0f + p3 * convection);
+        count++;
+    }
+    if (iterations != nullptr) {
+        *iterations = count;
+    }
+    float clothingTemperature = 100.0f * xn - 273.0f;
+
+    // Heat losses: skin diffusion, sweating, latent and dry respiration, radiation, convection
+    float loss1 = 3.05f * 0.001f * (5733.0f - 6.99f * metabolism - vaporPressure);
+    float loss2 = metabolism > 58.15f ? 0.42f * (metabolism - 58.15f) : 0.0f;
+    float loss3 = 1.7e-5f * metabolism * (5867.0f - vaporPressure);
+    float loss4 = 0.0014f * metabolism * (34.0f - temperature);
+    float loss5 = 3.96f * clothingArea * (xn * xn * xn * xn - radiant * radiant * radiant * radiant);
+    float loss6 = clothingArea * convection * (clothingTemperature - temperature);
+
+    float sensitivity = 0.303f * expf(-0.036f * metabolism) + 0.028f;
+    pmv = sensitivity * (metabolism - loss1 - loss2 - loss3 - loss4 - loss5 - loss6);
+    float pmv2 = pmv * pmv;
+    ppd = 100.0f - 95.0f * expf(-0.03353f * pmv2 * pmv2 - 0.2179f * pmv2);
+    return true;
+}
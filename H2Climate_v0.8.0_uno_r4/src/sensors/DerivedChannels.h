@@ -0,0 +1,19 @@
+#ifndef DERIVED_CHANNELS_H
+#define DERIVED_CHANNELS_H
+
+#include "../config/Config.h"
+#include "../sensors/SensorDriver.h"
+
+// Adds dew point, heat index, absolute humidity and PMV/PPD to a reading that
+// has temperature and humidity, for the channels enabled in Config.h
+void addDerivedChannels(SensorReading& reading);
+
+float saturationVaporPressure(float temperature); // hPa over water, Magnus formula from a lookup table
+float dewPoint(float temperature, float humidity); // °C, NAN at 0 %RH
+float heatIndex(float temperature, float humidity); // °C, NOAA Rothfusz regression
+float absoluteHumidity(float temperature, float humidity); // g/m³
+// ISO 7730 PMV and PPD with the comfort defaults from Config.h. Returns false when the
+// clothing temperature did not converge within COMFORT_MAX_ITERATIONS
+bool thermalComfort(float temperature, float humidity, float& pmv, float& ppd, int* iterations = nullptr);
+
+#endif // DERIVED_CHANNELS_H
@@ -0,0 +1,139 @@
+#include "Dht22Driver.h"
+
+const unsigned int START_SIGNAL_MICROS = 1100; // Host start pulse, datasheet asks for at least 1 ms
+const unsigned long FRAME_TIMEOUT_MICROS = 10000; // A full frame takes about 5 ms
+const unsigned long BIT_THRESHOLD_MICROS = 100; // Edge to edge: ~78 us for a 0, ~120 us for a 1
+
+Dht22Driver* Dht22Driver::instance = nullptr;
+
+Dht22Driver::Dht22Driver(int pin)
+    : pin(pin), capturing(false), edgeCount(0), startMicros(0), valid(false), temperature(NAN), humidity(NAN) {}
+
+//¤=======================================================================================¤
+
+bool Dht22Driver::begin() {
+    instance = this;
+    if (DHT22_POWER_PIN >= 0) {
+        pinMode(DHT22_POWER_PIN, OUTPUT);
+        digitalWrite(DHT22_POWER_PIN, HIGH);
+    }
+    pinMode(pin, INPUT_PULLUP);
+    return true; // The single-wire bus has no presence check outside a transaction
+}
+
+bool Dht22Driver::reset() {
+    if (capturing) {
+        finish(false);
+    }
+
+    if (DHT22_POWER_PIN >= 0) {
+        // Pull the data line low as well, or the sensor keeps itself powered through the pull-up
+        pinMode(pin, OUTPUT);
+        digitalWrite(pin, LOW);
+        digitalWrite(DHT22_POWER_PIN, LOW);
+        delay(DHT22_POWER_OFF_TIME);
+    }
+
+    // The sensor warms up again within its minimum sampling period, before the retry starts
+    return begin();
+}
+
+//¤=======================================================================================¤
+
+bool Dht22Driver::startMeasurement() {
+    if (capturing) {
+        return false;
+    }
+
+    // The start pulse is the only busy wait left, and it does not mask interrupts
+    pinMode(pin, OUTPUT);
+    digitalWrite(pin, LOW);
+    delayMicroseconds(START_SIGNAL_MICROS);
+
+    // Release the line and attach right after, the response edge follows within 20-40 us.
+    // The order is required on the RA4M1: pinMode() rewrites the whole PFS register and
+    // would clear the IRQ enable that attachInterrupt() sets. A missed response edge is
+    // recovered in poll() from the remaining 41 edges
+    edgeCount = 0;
+    capturing = true;
+    startMicros = micros();
+    pinMode(pin, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(pin), handleFallingEdge, FALLING);
+    return true;
+}
+
+//¤=======================================================================================¤
+
+bool Dht22Driver::poll() {
+    if (!capturing) {
+        return false;
+    }
+
+    if (edgeCount >= DHT22_FRAME_EDGES) {
+        finish(decode(1));
+        return true;
+    }
+
+    if (micros() - startMicros > FRAME_TIMEOUT_MICROS) {
+        // A missed response edge still leaves the 41 edges around the data bits
+        finish(edgeCount == DHT22_FRAME_EDGES - 1 && decode(0));
+        return true;
+    }
+
+    return false;
+}
+
+//¤=======================================================================================¤
+
+bool Dht22Driver::read(SensorReading& reading) {
+    if (!valid) {
+        return false;
+    }
+    reading.set(CHANNEL_TEMPERATURE, temperature);
+    reading.set(CHANNEL_HUMIDITY, humidity);
+    return true;
+}
+
+//¤=======================================================================================¤
+
+void Dht22Driver::handleFallingEdge() {
+    Dht22Driver* driver = instance;
+    if (driver->edgeCount < DHT22_FRAME_EDGES) {
+        driver->edgeMicros[driver->edgeCount] = micros();
+        driver->edgeCount++;
+    }
+}
+
+void Dht22Driver::finish(bool success) {
+    detachInterrupt(digitalPinToInterrupt(pin));
+    capturing = false;
+    valid = success;
+    if (!success) {
+        temperature = NAN;
+        humidity = NAN;
+    }
+}
+
+bool Dht22Driver::decode(int firstBitEdge) {
+    uint8_t data[5] = { 0, 0, 0, 0, 0 };
+
+    // Bit i is the gap between the falling edges that open bit i and bit i + 1
+    for (int i = 0; i < 40; i++) {
+        unsigned long period = edgeMicros[firstBitEdge + i + 1] - edgeMicros[firstBitEdge + i];
+        data[i / 8] <<= 1;
+        if (period > BIT_THRESHOLD_MICROS) {
+            data[i / 8] |= 1;
+        }
+    }
+
+    if ((uint8_t)(data[0] + data[1] + data[2] + data[3]) != data[4]) {
+        return false;
+    }
+
+    humidity = ((data[0] << 8) | data[1]) * 0.1f;
+    temperature = (((data[2] & 0x7F) << 8) | data[3]) * 0.1f;
+    if (data[2] & 0x80) {
+        temperature = -temperature;
+    }
+    return true;
+}
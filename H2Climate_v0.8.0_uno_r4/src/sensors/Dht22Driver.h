@@ -0,0 +1,38 @@
+#ifndef DHT22_DRIVER_H
+#define DHT22_DRIVER_H
+
+#include "../config/Config.h"
+#include "../sensors/SensorDriver.h"
+
+// Number of falling edges in one frame: response, 40 data bits and the end-of-frame pulse
+const int DHT22_FRAME_EDGES = 42;
+
+// Interrupt driven DHT22 decoder. Edges are timestamped in a pin interrupt and the
+// 40-bit frame is decoded in poll(), so interrupts stay enabled during a transaction.
+class Dht22Driver : public SensorDriver {
+  public:
+    Dht22Driver(int pin);
+    const char* getName() override { return "DHT22"; }
+    bool begin() override;
+    bool reset() override; // Power-cycles the sensor when DHT22_POWER_PIN is set
+    bool startMeasurement() override; // Returns false while a measurement is already running
+    bool poll() override;
+    bool read(SensorReading& reading) override;
+    unsigned long getMinSamplingPeriod() override { return DHT22_MIN_SAMPLING_PERIOD; }
+
+  private:
+    static Dht22Driver* instance;
+    static void handleFallingEdge();
+    int pin;
+    volatile bool capturing;
+    volatile uint8_t edgeCount;
+    volatile unsigned long edgeMicros[DHT22_FRAME_EDGES];
+    unsigned long startMicros;
+    bool valid;
+    float temperature;
+    float humidity;
+    void finish(bool success);
+    bool decode(int firstBitEdge); // Index of the falling edge that opens the first data bit
+};
+
+#endif // DHT22_DRIVER_H
@@ -0,0 +1,88 @@
+#include "OccupancyDetector.h"
+
+static inline int32_t toFixed(float value) {
+    return (int32_t)lroundf(value * (1 << OCCUPANCY_FRACTION_BITS));
+}
+
+// Share of a feature in percent of its "fully occupied" level, 0-100
+static inline int32_t toPercent(int32_t feature, int32_t fullLevel) {
+    if (feature <= 0 || fullLevel <= 0) {
+        return 0;
+    }
+    return min((int64_t)feature * 100 / fullLevel, (int64_t)100);
+}
+
+OccupancyDetector::OccupancyDetector()
+    : count(0), next(0), likelihood(0), changeDetected(false), lastCostMicros(0) {}
+
+//¤=======================================================================================¤
+
+void OccupancyDetector::update(SensorReading& reading, unsigned long currentMillis) {
+    if (!reading.has(CHANNEL_TEMPERATURE) || !reading.has(CHANNEL_HUMIDITY)) {
+        return;
+    }
+
+    unsigned long startMicros = micros();
+    int window = min(OCCUPANCY_WINDOW, OCCUPANCY_MAX_WINDOW);
+
+    temperatures[next] = toFixed(reading.values[CHANNEL_TEMPERATURE]);
+    humidities[next] = toFixed(reading.values[CHANNEL_HUMIDITY]);
+    sampleMillis[next] = currentMillis;
+    next = (next + 1) % window;
+    if (count < window) {
+        count++;
+    }
+    if (count < window) {
+        return; // Slopes over a half-filled window are mostly noise
+    }
+
+    // Tenths of a second since the oldest sample, the order inside the window does not matter
+    unsigned long oldest = sampleMillis[next];
+    int32_t times[OCCUPANCY_MAX_WINDOW];
+    for (int i = 0; i < count; i++) {
+        times[i] = (sampleMillis[i] - oldest) / 100;
+    }
+
+    int32_t temperatureSlope, temperatureVariance, humiditySlope, humidityVariance;
+    features(temperatures, times, temperatureSlope, temperatureVariance);
+    features(humidities, times, humiditySlope, humidityVariance);
+
+    int32_t humiditySlopeLevel = toFixed(OCCUPANCY_HUMIDITY_SLOPE);
+    int32_t temperatureSlopeLevel = toFixed(OCCUPANCY_TEMPERATURE_SLOPE);
+    int32_t varianceLevel = (int32_t)lroundf(OCCUPANCY_HUMIDITY_VARIANCE * (1 << (2 * OCCUPANCY_FRACTION_BITS)));
+
+    // Rising humidity and temperature mean people, falling ones only count towards a change
+    int32_t raw = (toPercent(humiditySlope, humiditySlopeLevel) * OCCUPANCY_HUMIDITY_SLOPE_WEIGHT +
+                   toPercent(temperatureSlope, temperatureSlopeLevel) * OCCUPANCY_TEMPERATURE_SLOPE_WEIGHT +
+                   toPercent(humidityVariance, varianceLevel) * OCCUPANCY_HUMIDITY_VARIANCE_WEIGHT) / 100;
+
+    likelihood = max((int)raw, likelihood - OCCUPANCY_DECAY);
+    changeDetected = raw >= OCCUPANCY_CHANGE_LIKELIHOOD || abs(humiditySlope) >= humiditySlopeLevel ||
+                     abs(temperatureSlope) >= temperatureSlopeLevel;
+
+    reading.set(CHANNEL_OCCUPANCY, likelihood);
+    lastCostMicros = micros() - startMicros;
+}
+
+//¤=======================================================================================¤
+
+void OccupancyDetector::features(const int32_t* values, const int32_t* times, int32_t& slope, int32_t& variance) {
+    int64_t n = count;
+    int64_t sumX = 0, sumY = 0, sumXX = 0, sumXY = 0, sumYY = 0;
+    for (int i = 0; i < count; i++) {
+        int64_t x = times[i];
+        int64_t y = values[i];
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+        sumYY += y * y;
+    }
+
+    // Least-squares slope in Q.8 per tenth of a second, scaled to per minute
+    int64_t denominator = n * sumXX - sumX * sumX;
+    slope = denominator > 0 ? (int32_t)((n * sumXY - sumX * sumY) * 600 / denominator) : 0;
+
+    // Population variance in Q.16
+    variance = (int32_t)((n * sumYY - sumY * sumY) / (n * n));
+}
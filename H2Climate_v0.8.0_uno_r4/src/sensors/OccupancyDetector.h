@@ -0,0 +1,33 @@
+#ifndef OCCUPANCY_DETECTOR_H
+#define OCCUPANCY_DETECTOR_H
+
+#include "../config/Config.h"
+#include "../sensors/SensorDriver.h"
+
+const int OCCUPANCY_FRACTION_BITS = 8; // Values are kept as Q23.8 fixed point
+const int OCCUPANCY_MAX_WINDOW = 16;
+
+// Infers room occupancy from the slope of humidity and temperature and the
+// variance of humidity over a short sliding window. Least-squares sums are
+// recomputed in fixed point every sample, O(window) with no allocation.
+class OccupancyDetector {
+  public:
+    OccupancyDetector();
+    void update(SensorReading& reading, unsigned long currentMillis); // Adds the occupancy channel once the window is full
+    int getLikelihood() { return likelihood; } // Percent
+    bool isChangeDetected() { return changeDetected; } // True while the room is changing, the loop samples faster
+    unsigned long getLastCostMicros() { return lastCostMicros; }
+
+  private:
+    int32_t temperatures[OCCUPANCY_MAX_WINDOW];
+    int32_t humidities[OCCUPANCY_MAX_WINDOW];
+    unsigned long sampleMillis[OCCUPANCY_MAX_WINDOW];
+    int count;
+    int next;
+    int likelihood;
+    bool changeDetected;
+    unsigned long lastCostMicros;
+    void features(const int32_t* values, const int32_t* times, int32_t& slope, int32_t& variance);
+};
+
+#endif // OCCUPANCY_DETECTOR_H
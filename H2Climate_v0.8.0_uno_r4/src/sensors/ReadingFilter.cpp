@@ -0,0 +1,146 @@
+#include "ReadingFilter.h"
+
+static inline int32_t toFixed(float value) {
+    return (int32_t)lroundf(value * (1 << FILTER_FRACTION_BITS));
+}
+
+static inline float fromFixed(int32_t value) {
+    return (float)value / (1 << FILTER_FRACTION_BITS);
+}
+
+ReadingFilter::ReadingFilter() : lastCostMicros(0) {
+    for (int i = 0; i < SENSOR_CHANNEL_COUNT; i++) {
+        channels[i].primed = false;
+        channels[i].consecutiveRejects = 0;
+        channels[i].rejected = 0;
+    }
+}
+
+//¤=======================================================================================¤
+
+void ReadingFilter::apply(SensorReading& reading) {
+    unsigned long startMicros = micros();
+
+    for (int channel = 0; channel < SENSOR_CHANNEL_COUNT; channel++) {
+        if (!reading.has((SensorChannel)channel)) {
+            continue;
+        }
+
+        int32_t value = toFixed(reading.values[channel]);
+        ChannelState& state = channels[channel];
+
+        if (!isPlausible(channel, value)) {
+            state.rejected++;
+
+            // A jump that keeps coming back is a real change, start over from it. Impossible
+            // values are sensor faults and never count towards a new level
+            if (isInRange(channel, value)) {
+                state.consecutiveRejects++;
+            }
+            if (!isInRange(channel, value) || state.consecutiveRejects < FILTER_MAX_CONSECUTIVE_REJECTS) {
+                reading.channelMask &= ~(1 << channel);
+                continue;
+            }
+            reset(channel, value);
+        }
+
+        state.consecutiveRejects = 0;
+        reading.values[channel] = fromFixed(filter(channel, value));
+    }
+
+    if (reading.channelMask == 0) {
+        reading.status = SENSOR_READ_FAILED;
+    }
+
+    lastCostMicros = micros() - startMicros;
+}
+
+//¤=======================================================================================¤
+
+bool ReadingFilter::isInRange(int channel, int32_t value) {
+    return value >= toFixed(CHANNEL_MIN_VALUE[channel]) && value <= toFixed(CHANNEL_MAX_VALUE[channel]);
+}
+
+bool ReadingFilter::isPlausible(int channel, int32_t value) {
+    if (!isInRange(channel, value)) {
+        return false;
+    }
+
+    ChannelState& state = channels[channel];
+    if (!state.primed) {
+        return true;
+    }
+
+    int32_t step = value - state.lastAccepted;
+    if (step < 0) {
+        step = -step;
+    }
+    return step <= toFixed(CHANNEL_MAX_STEP[channel]);
+}
+
+void ReadingFilter::reset(int channel, int32_t value) {
+    ChannelState& state = channels[channel];
+    state.primed = true;
+    state.lastAccepted = value;
+    state.windowCount = 0;
+    state.windowIndex = 0;
+    state.ema = value;
+    state.kalmanEstimate = value;
+    state.kalmanVariance = toFixed(CHANNEL_KALMAN_R[channel]);
+}
+
+int32_t ReadingFilter::filter(int channel, int32_t value) {
+    ChannelState& state = channels[channel];
+    if (!state.primed) {
+        reset(channel, value);
+    }
+    state.lastAccepted = value;
+
+    uint8_t stages = CHANNEL_FILTER_STAGES[channel];
+
+    if (stages & FILTER_MEDIAN) {
+        value = median(state, value);
+    }
+
+    if (stages & FILTER_EMA) {
+        // ema += alpha * (value - ema)
+        int32_t alpha = toFixed(CHANNEL_EMA_ALPHA[channel]);
+        state.ema += (int32_t)(((int64_t)alpha * (value - state.ema)) >> FILTER_FRACTION_BITS);
+        value = state.ema;
+    }
+
+    if (stages & FILTER_KALMAN) {
+        // Constant-level model: predict, then correct with gain K = P / (P + R)
+        int64_t processNoise = toFixed(CHANNEL_KALMAN_Q[channel]);
+        int64_t measurementNoise = toFixed(CHANNEL_KALMAN_R[channel]);
+        state.kalmanVariance += processNoise;
+        int64_t gain = (state.kalmanVariance << FILTER_FRACTION_BITS) / (state.kalmanVariance + measurementNoise);
+        state.kalmanEstimate += (int32_t)((gain * (value - state.kalmanEstimate)) >> FILTER_FRACTION_BITS);
+        state.kalmanVariance = (((1 << FILTER_FRACTION_BITS) - gain) * state.kalmanVariance) >> FILTER_FRACTION_BITS;
+        value = state.kalmanEstimate;
+    }
+
+    return value;
+}
+
+int32_t ReadingFilter::median(ChannelState& state, int32_t value) {
+    int windowSize = constrain(FILTER_MEDIAN_WINDOW, 1, FILTER_MAX_MEDIAN_WINDOW);
+    state.window[state.windowIndex] = value;
+    state.windowIndex = (state.windowIndex + 1) % windowSize;
+    if (state.windowCount < windowSize) {
+        state.windowCount++;
+    }
+
+    // Insertion sort of at most seven values
+    int32_t sorted[FILTER_MAX_MEDIAN_WINDOW];
+    for (int i = 0; i < state.windowCount; i++) {
+        int32_t current = state.window[i];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > current) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = current;
+    }
+    return sorted[state.windowCount / 2];
+}
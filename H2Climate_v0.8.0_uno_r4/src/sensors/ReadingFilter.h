@@ -0,0 +1,42 @@
+#ifndef READING_FILTER_H
+#define READING_FILTER_H
+
+#include "../config/Config.h"
+#include "../sensors/SensorDriver.h"
+
+const int FILTER_FRACTION_BITS = 8; // Values are kept as Q23.8 fixed point
+const int FILTER_MAX_MEDIAN_WINDOW = 7;
+
+// Per-channel filter chain between the SensorManager and the upload buffer.
+// Rejects impossible values and jumps, then runs the configured median, EMA and
+// Kalman stages in fixed point.
+class ReadingFilter {
+  public:
+    ReadingFilter();
+    void apply(SensorReading& reading); // Filters in place, rejected channels are removed
+    unsigned long getRejectedCount(SensorChannel channel) { return channels[channel].rejected; }
+    unsigned long getLastCostMicros() { return lastCostMicros; }
+
+  private:
+    struct ChannelState {
+      bool primed; // False until the first accepted sample
+      int32_t lastAccepted;
+      int32_t window[FILTER_MAX_MEDIAN_WINDOW];
+      int windowCount;
+      int windowIndex;
+      int32_t ema;
+      int32_t kalmanEstimate;
+      int64_t kalmanVariance;
+      int consecutiveRejects; // In-range step rejections since the last accepted value
+      unsigned long rejected;
+    };
+    ChannelState channels[SENSOR_CHANNEL_COUNT];
+    unsigned long lastCostMicros;
+    bool isInRange(int channel, int32_t value);
+    bool isPlausible(int channel, int32_t value); // In range and within the step limit of the last accepted value
+    void reset(int channel, int32_t value);
+    int32_t median(ChannelState& state, int32_t value);
+    int32_t filter(int channel, int32_t value);
+};
+
+#endif // READING_FILTER_H
@@ -0,0 +1,136 @@
+#include "Scd4xDriver.h"
+#include "SensirionCrc.h"
+
+const uint16_t SCD4X_STOP_PERIODIC_MEASUREMENT = 0x3F86;
+const uint16_t SCD4X_START_PERIODIC_MEASUREMENT = 0x21B1;
+const uint16_t SCD4X_MEASURE_SINGLE_SHOT = 0x219D; // SCD41 and SCD43 only
+const uint16_t SCD4X_READ_MEASUREMENT = 0xEC05;
+const uint16_t SCD4X_GET_DATA_READY_STATUS = 0xE4B8;
+const uint16_t SCD4X_GET_SENSOR_VARIANT = 0x202F;
+const unsigned long SCD4X_CONVERSION_MILLIS = 5000;
+const unsigned long SCD4X_READY_CHECK_INTERVAL = 250; // Periodic mode, how often poll() asks for new data
+
+// Sensor variant in bits 15:12 of get_sensor_variant
+const uint16_t SCD4X_VARIANT_MASK = 0xF000;
+const uint16_t SCD4X_VARIANT_SCD41 = 0x1000;
+const uint16_t SCD4X_VARIANT_SCD43 = 0x5000;
+
+Scd4xDriver::Scd4xDriver(uint8_t address)
+    : address(address), singleShot(false), measuring(false), startMillis(0), readyCheckMillis(0), valid(false), co2(NAN) {}
+
+//¤=======================================================================================¤
+
+bool Scd4xDriver::begin() {
+    Wire.begin();
+
+    // The sensor may still be in periodic mode from an earlier run, it needs 500 ms to stop
+    if (!sendCommand(SCD4X_STOP_PERIODIC_MEASUREMENT)) {
+        return false;
+    }
+    delay(500);
+
+    // Older SCD40 firmware does not know the variant command either, periodic mode works on all of them
+    uint16_t variant;
+    singleShot = readWord(SCD4X_GET_SENSOR_VARIANT, variant) &&
+                 ((variant & SCD4X_VARIANT_MASK) == SCD4X_VARIANT_SCD41 || (variant & SCD4X_VARIANT_MASK) == SCD4X_VARIANT_SCD43);
+    if (singleShot) {
+        return true;
+    }
+    return sendCommand(SCD4X_START_PERIODIC_MEASUREMENT);
+}
+
+bool Scd4xDriver::startMeasurement() {
+    if (measuring) {
+        return false;
+    }
+    // In periodic mode the sensor is already measuring, wait for its next result
+    measuring = !singleShot || sendCommand(SCD4X_MEASURE_SINGLE_SHOT);
+    startMillis = millis();
+    valid = false;
+    return measuring;
+}
+
+bool Scd4xDriver::poll() {
+    if (!measuring) {
+        return false;
+    }
+    if (singleShot && millis() - startMillis < SCD4X_CONVERSION_MILLIS) {
+        return false;
+    }
+    if (!singleShot) {
+        if (millis() - readyCheckMillis < SCD4X_READY_CHECK_INTERVAL) {
+            return false;
+        }
+        readyCheckMillis = millis();
+        if (!isDataReady()) {
+            return false;
+        }
+    }
+    measuring = false;
+
+    if (!sendCommand(SCD4X_READ_MEASUREMENT)) {
+        return true;
+    }
+    delay(1); // Command execution time before the result can be read
+
+    // CO2, temperature and humidity words, each followed by its CRC
+    uint8_t data[9];
+    if (Wire.requestFrom(address, (uint8_t)9) != 9) {
+        return true;
+    }
+    for (int i = 0; i < 9; i++) {
+        data[i] = Wire.read();
+    }
+
+    if (sensirionCrc8(data, 2) != data[2]) {
+        return true;
+    }
+
+    // Temperature and humidity are skewed by self-heating, only CO2 is reported
+    co2 = (float)((data[0] << 8) | data[1]);
+    valid = true;
+    return true;
+}
+
+bool Scd4xDriver::read(SensorReading& reading) {
+    if (!valid) {
+        return false;
+    }
+    reading.set(CHANNEL_CO2, co2);
+    return true;
+}
+
+//¤=======================================================================================¤
+
+bool Scd4xDriver::sendCommand(uint16_t command) {
+    Wire.beginTransmission(address);
+    Wire.write((uint8_t)(command >> 8));
+    Wire.write((uint8_t)(command & 0xFF));
+    return Wire.endTransmission() == 0;
+}
+
+bool Scd4xDriver::readWord(uint16_t command, uint16_t& value) {
+    if (!sendCommand(command)) {
+        return false;
+    }
+    delay(1); // Command execution time before the result can be read
+
+    uint8_t data[3];
+    if (Wire.requestFrom(address, (uint8_t)3) != 3) {
+        return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        data[i] = Wire.read();
+    }
+    if (sensirionCrc8(data, 2) != data[2]) {
+        return false;
+    }
+    value = (data[0] << 8) | data[1];
+    return true;
+}
+
+bool Scd4xDriver::isDataReady() {
+    // Any of the lower 11 bits set means a new measurement waits
+    uint16_t status;
+    return readWord(SCD4X_GET_DATA_READY_STATUS, status) && (status & 0x07FF) != 0;
+}
@@ -0,0 +1,34 @@
+#ifndef SCD4X_DRIVER_H
+#define SCD4X_DRIVER_H
+
+#include <Wire.h>
+#include "../config/Config.h"
+#include "../sensors/SensorDriver.h"
+
+// Sensirion SCD4x CO2 sensor on I2C. The SCD41 and SCD43 run single shots so they
+// idle between samples, the SCD40 has no single-shot command and measures periodically.
+class Scd4xDriver : public SensorDriver {
+  public:
+    Scd4xDriver(uint8_t address);
+    const char* getName() override { return "SCD4x"; }
+    bool begin() override;
+    bool startMeasurement() override;
+    bool poll() override;
+    bool read(SensorReading& reading) override;
+    unsigned long getMinSamplingPeriod() override { return 5000; }
+    bool isSingleShot() { return singleShot; } // False on the SCD40 or when the variant is unknown
+
+  private:
+    uint8_t address;
+    bool singleShot;
+    bool measuring;
+    unsigned long startMillis;
+    unsigned long readyCheckMillis;
+    bool valid;
+    float co2;
+    bool sendCommand(uint16_t command);
+    bool readWord(uint16_t command, uint16_t& value); // Command, then one CRC-checked word
+    bool isDataReady();
+};
+
+#endif // SCD4X_DRIVER_H
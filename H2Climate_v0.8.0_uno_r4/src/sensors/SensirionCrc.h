@@ -0,0 +1,18 @@
+#ifndef SENSIRION_CRC_H
+#define SENSIRION_CRC_H
+
+#include "../config/Config.h"
+
+// CRC-8 used by Sensirion sensors (polynomial 0x31, init 0xFF) over each 16-bit word
+inline uint8_t sensirionCrc8(const uint8_t* data, int len) {
+    uint8_t crc = 0xFF;
+    for (int i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+#endif // SENSIRION_CRC_H
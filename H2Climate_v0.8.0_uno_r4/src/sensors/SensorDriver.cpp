@@ -0,0 +1,18 @@
+#include "SensorDriver.h"
+
+const char* getChannelName(SensorChannel channel) {
+    switch (channel) {
+        case CHANNEL_TEMPERATURE: return "temperature";
+        case CHANNEL_HUMIDITY: return "humidity";
+        case CHANNEL_CO2: return "co2";
+        case CHANNEL_PRESSURE: return "pressure";
+        case CHANNEL_DEW_POINT: return "dewPoint";
+        case CHANNEL_HEAT_INDEX: return "heatIndex";
+        case CHANNEL_ABSOLUTE_HUMIDITY: return "absoluteHumidity";
+        case CHANNEL_SOUND_LEVEL: return "soundLevel";
+        case CHANNEL_OCCUPANCY: return "occupancy";
+        case CHANNEL_PMV: return "pmv";
+        case CHANNEL_PPD: return "ppd";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef SENSOR_DRIVER_H
+#define SENSOR_DRIVER_H
+
+#include "../config/Config.h"
+
+enum SensorChannel {
+  CHANNEL_TEMPERATURE,
+  CHANNEL_HUMIDITY,
+  CHANNEL_CO2,
+  CHANNEL_PRESSURE,
+  CHANNEL_DEW_POINT, // Derived from temperature and humidity
+  CHANNEL_HEAT_INDEX,
+  CHANNEL_ABSOLUTE_HUMIDITY,
+  CHANNEL_SOUND_LEVEL, // A-weighted Leq in dBA
+  CHANNEL_OCCUPANCY, // Likelihood in percent, inferred from humidity and temperature
+  CHANNEL_PMV, // ISO 7730 predicted mean vote, -3 cold to +3 hot
+  CHANNEL_PPD, // Predicted percentage dissatisfied
+  SENSOR_CHANNEL_COUNT
+};
+
+enum SensorStatus {
+  SENSOR_OK,
+  SENSOR_PARTIAL, // Some drivers failed, the channels they provide are missing
+  SENSOR_CACHED, // Reading was already returned by an earlier read()
+  SENSOR_READ_FAILED
+};
+
+// One batch of measurements, a variable set of channels
+struct SensorReading {
+  float values[SENSOR_CHANNEL_COUNT];
+  uint16_t channelMask; // Bit per channel present in this reading
+  SensorStatus status;
+  unsigned long timestamp; // millis() when the batch completed
+  unsigned long latencyMicros; // From starting the batch until the last driver finished
+
+  bool has(SensorChannel channel) const { return channelMask & (1 << channel); }
+  float get(SensorChannel channel) const { return has(channel) ? values[channel] : NAN; }
+  void set(SensorChannel channel, float value) {
+    values[channel] = value;
+    channelMask |= (1 << channel);
+  }
+};
+
+const char* getChannelName(SensorChannel channel); // Key used in the JSON payload
+
+// Interface every sensor driver implements. The manager starts all drivers at
+// once and collects the results as each conversion finishes.
+class SensorDriver {
+  public:
+    virtual ~SensorDriver() {}
+    virtual const char* getName() = 0;
+    virtual bool begin() = 0; // Returns false when the sensor does not respond
+    virtual bool reset() { return begin(); } // Recovers a wedged sensor, drivers with a power switch cycle it here
+    virtual bool startMeasurement() = 0;
+    virtual bool poll() = 0; // Returns true once when the started measurement has finished
+    virtual bool read(SensorReading& reading) = 0; // Adds its channels, false when the measurement failed
+    virtual unsigned long getMinSamplingPeriod() = 0;
+};
+
+#endif // SENSOR_DRIVER_H
@@ -1,35 +1,199 @@
 #include "SensorManager.h"
 
 SensorManager::SensorManager(FancyLog& fancyLog)
-    : fancyLog(fancyLog), dht(DHT22_PIN, DHTTYPE) {}
+    : fancyLog(fancyLog), driverCount(0), attemptMask(0), pendingMask(0), failedMask(0), retryMask(0),
+      retriesLeft(0), retryAtMillis(0), minSamplingPeriod(0), warmupStartMillis(0), lastStartMillis(0),
+      lastStartMicros(0), attemptStartMillis(0), attemptStartMicros(0), started(false), newReading(false) {
+    lastReading.channelMask = 0;
+    lastReading.status = SENSOR_READ_FAILED;
+    lastReading.timestamp = 0;
+    lastReading.latencyMicros = 0;
+    batchReading = lastReading;
+}
+
+bool SensorManager::addDriver(SensorDriver& driver) {
+    if (driverCount >= MAX_SENSOR_DRIVERS) {
+        fancyLog.toSerial("Too many sensor drivers, ignoring " + String(driver.getName()), ERROR);
+        return false;
+    }
+    
+    drivers[driverCount] = &driver;
+    driverReady[driverCount] = false;
+    health[driverCount] = { 0, 0, 0, 0, 0, 0 };
+    driverCount++;
+    
+    // The batch can only run as often as its slowest member allows
+    if (driver.getMinSamplingPeriod() > minSamplingPeriod) {
+        minSamplingPeriod = driver.getMinSamplingPeriod();
+    }
+    return true;
+}
 
 void SensorManager::begin() {
-    fancyLog.toSerial("Initializing DHT sensor", INFO);
-    dht.begin();
+    for (int i = 0; i < driverCount; i++) {
+        fancyLog.toSerial("Initializing " + String(drivers[i]->getName()) + " sensor", INFO);
+        driverReady[i] = drivers[i]->begin();
+        if (!driverReady[i]) {
+            fancyLog.toSerial(String(drivers[i]->getName()) + " sensor not responding, skipping it", WARNING);
+        }
+    }
     
-    // Give the sensor time to stabilize - this is critical
-    // Using the exact same delay as in the original code
-    delay(2000);
+    // The sensors stabilize while the rest of the boot runs, isReady() tells when they are done
+    warmupStartMillis = millis();
+    fancyLog.toSerial("Sensors warming up", INFO);
+}
+
+bool SensorManager::startReading() {
+    unsigned long currentMillis = millis();
     
-    // Attempt an initial reading to verify the sensor is working
-    float temp = dht.readTemperature();
-    float hum = dht.readHumidity();
+    // A new transaction inside the sampling period would only return stale or corrupt data
+    if (!isReady() || pendingMask != 0 || retryMask != 0 || (started && currentMillis - attemptStartMillis < minSamplingPeriod)) {
+        return false;
+    }
     
-    if (isnan(temp) || isnan(hum)) {
-        fancyLog.toSerial("Initial sensor reading failed, but continuing anyway", WARNING);
-    } else {
-        fancyLog.toSerial("Initial reading: Temp=" + String(temp) + "°C, Humidity=" + String(hum) + "%", INFO);
+    lastStartMillis = currentMillis;
+    lastStartMicros = micros();
+    started = true;
+    
+    batchReading.channelMask = 0;
+    retriesLeft = SENSOR_MAX_RETRIES;
+    startAttempt((1 << driverCount) - 1);
+    return true;
+}
+
+void SensorManager::poll() {
+    // Start a scheduled retry once the failed drivers may sample again
+    if (retryMask != 0 && (long)(millis() - retryAtMillis) >= 0) {
+        uint16_t mask = retryMask;
+        retryMask = 0;
+        startAttempt(mask);
+        return;
+    }
+
+    if (pendingMask == 0) {
+        return;
+    }
+    
+    for (int i = 0; i < driverCount; i++) {
+        if ((pendingMask & (1 << i)) && drivers[i]->poll()) {
+            pendingMask &= ~(1 << i);
+            health[i].lastLatencyMicros = micros() - attemptStartMicros;
+            if (health[i].lastLatencyMicros > health[i].maxLatencyMicros) {
+                health[i].maxLatencyMicros = health[i].lastLatencyMicros;
+            }
+        }
+    }
+    
+    // A driver that never finishes must not hold back the others forever
+    if (pendingMask != 0 && millis() - attemptStartMillis > SENSOR_BATCH_TIMEOUT) {
+        fancyLog.toSerial("Sensor batch timed out", WARNING);
+        failedMask |= pendingMask; // Whatever they hold is from an earlier conversion
+        pendingMask = 0;
+    }
+    
+    if (pendingMask == 0) {
+        finishAttempt();
     }
+}
+
+//¤=======================================================================================¤
+
+void SensorManager::startAttempt(uint16_t mask) {
+    attemptMask = mask;
+    failedMask = 0;
+    attemptStartMillis = millis();
+    attemptStartMicros = micros();
     
-    fancyLog.toSerial("DHT sensor initialized", INFO);
+    // Kick off every conversion before waiting for any of them
+    for (int i = 0; i < driverCount; i++) {
+        if (!(mask & (1 << i))) {
+            continue;
+        }
+        if (driverReady[i] && drivers[i]->startMeasurement()) {
+            pendingMask |= (1 << i);
+        } else {
+            failedMask |= (1 << i);
+        }
+    }
+    
+    if (pendingMask == 0) {
+        finishAttempt(); // Nothing could be started, handle the failures right away
+    }
 }
 
-float SensorManager::readTemperature() {
-    // Direct call to DHT sensor exactly like original code
-    return dht.readTemperature();
+void SensorManager::finishAttempt() {
+    for (int i = 0; i < driverCount; i++) {
+        if (!(attemptMask & (1 << i))) {
+            continue;
+        }
+        bool success = !(failedMask & (1 << i)) && drivers[i]->read(batchReading);
+        if (!success) {
+            failedMask |= (1 << i);
+        }
+        recordResult(i, success);
+    }
+    
+    // Retry the failed drivers in this slot if they may sample again soon enough
+    if (failedMask != 0 && retriesLeft > 0) {
+        unsigned long retryDelay = 0;
+        for (int i = 0; i < driverCount; i++) {
+            if ((failedMask & (1 << i)) && drivers[i]->getMinSamplingPeriod() > retryDelay) {
+                retryDelay = drivers[i]->getMinSamplingPeriod();
+            }
+        }
+        
+        unsigned long retryAt = attemptStartMillis + retryDelay;
+        if (retryAt - lastStartMillis <= SENSOR_RETRY_MAX_DELAY) {
+            retriesLeft--;
+            retryMask = failedMask;
+            retryAtMillis = retryAt;
+            fancyLog.toSerial("Retrying failed sensors in " + String(retryAt - millis()) + " ms", WARNING);
+            return;
+        }
+    }
+    
+    finishBatch();
 }
 
-float SensorManager::readHumidity() {
-    // Direct call to DHT sensor exactly like original code
-    return dht.readHumidity();
+void SensorManager::recordResult(int index, bool success) {
+    SensorHealth& stats = health[index];
+    stats.reads++;
+    if (success) {
+        stats.consecutiveFailures = 0;
+        return;
+    }
+    
+    stats.failures++;
+    stats.consecutiveFailures++;
+    
+    // Every SENSOR_REINIT_THRESHOLD failures in a row, so a dead sensor is not reset on every slot
+    if (stats.consecutiveFailures % SENSOR_REINIT_THRESHOLD == 0) {
+        fancyLog.toSerial(String(drivers[index]->getName()) + " failed " + String(stats.consecutiveFailures) + " times in a row, re-initializing", WARNING);
+        driverReady[index] = drivers[index]->reset();
+        stats.reinits++;
+    }
+}
+
+void SensorManager::finishBatch() {
+    SensorReading reading = batchReading;
+    reading.timestamp = millis();
+    reading.latencyMicros = micros() - lastStartMicros;
+    
+    if (reading.channelMask == 0) {
+        reading.status = SENSOR_READ_FAILED;
+    } else {
+        reading.status = failedMask != 0 ? SENSOR_PARTIAL : SENSOR_OK;
+    }
+    
+    lastReading = reading;
+    newReading = true;
+}
+
+SensorReading SensorManager::read() {
+    SensorReading reading = lastReading;
+    if (!newReading && reading.status != SENSOR_READ_FAILED) {
+        reading.status = SENSOR_CACHED;
+    }
+    newReading = false;
+    return reading;
 }
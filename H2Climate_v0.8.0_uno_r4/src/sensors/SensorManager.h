@@ -2,18 +2,63 @@
 #define SENSOR_MANAGER_H
 
 #include "../config/Config.h"
+#include "../sensors/SensorDriver.h"
 #include "../utils/FancyLog.h"
 
+// Per-driver counters since boot, retries count as separate reads
+struct SensorHealth {
+  unsigned long reads;
+  unsigned long failures;
+  unsigned int consecutiveFailures;
+  unsigned long lastLatencyMicros; // From starting the conversion until the driver finished
+  unsigned long maxLatencyMicros;
+  unsigned long reinits;
+};
+
+// Registry of sensor drivers with a batched scheduler: every driver starts its
+// conversion at the same time, so conversion times overlap instead of adding up.
+// Drivers that fail are retried within the same slot and re-initialized after
+// SENSOR_REINIT_THRESHOLD failures in a row.
 class SensorManager {
   public:
     SensorManager(FancyLog& fancyLog);
-    void begin();
-    float readTemperature();
-    float readHumidity();
+    bool addDriver(SensorDriver& driver); // Later drivers override earlier ones on shared channels
+    void begin(); // Starts the drivers, returns without waiting for the warm-up
+    bool isReady() { return millis() - warmupStartMillis >= SENSOR_WARMUP_TIME; }
+    bool startReading(); // Returns false while warming up, busy or inside the minimum sampling period
+    void poll(); // Call every loop pass, collects finished conversions and runs retries
+    bool hasNewReading() { return newReading; }
+    SensorReading read(); // Latest finished batch, never touches the bus
+    int getDriverCount() { return driverCount; }
+    const char* getDriverName(int index) { return drivers[index]->getName(); }
+    const SensorHealth& getHealth(int index) { return health[index]; }
 
   private:
-    DHT dht;
     FancyLog& fancyLog;
+    SensorDriver* drivers[MAX_SENSOR_DRIVERS];
+    bool driverReady[MAX_SENSOR_DRIVERS]; // False when begin() found no sensor
+    SensorHealth health[MAX_SENSOR_DRIVERS];
+    int driverCount;
+    uint16_t attemptMask; // Bit per driver taking part in the running attempt
+    uint16_t pendingMask; // Bit per driver still converting
+    uint16_t failedMask; // Bit per driver that failed the running attempt
+    uint16_t retryMask; // Bit per driver waiting for its retry
+    int retriesLeft;
+    unsigned long retryAtMillis;
+    unsigned long minSamplingPeriod;
+    SensorReading batchReading; // Collects the channels of every attempt in the slot
+    SensorReading lastReading;
+    unsigned long warmupStartMillis;
+    unsigned long lastStartMillis; // Start of the sampling slot
+    unsigned long lastStartMicros;
+    unsigned long attemptStartMillis;
+    unsigned long attemptStartMicros;
+    bool started;
+    bool newReading;
+    void startAttempt(uint16_t mask);
+    void finishAttempt();
+    void recordResult(int index, bool success);
+    void finishBatch();
 };
 
-#endif // SENSOR_MANAGER_H 
\ No newline at end of file
+#endif // SENSOR_MANAGER_H
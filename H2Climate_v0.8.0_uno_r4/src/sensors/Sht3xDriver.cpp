@@ -0,0 +1,70 @@
+#include "Sht3xDriver.h"
+#include "SensirionCrc.h"
+
+const uint16_t SHT3X_MEASURE_HIGH_REPEATABILITY = 0x2400; // No clock stretching
+const unsigned long SHT3X_CONVERSION_MILLIS = 16; // Datasheet max is 15.5 ms
+
+Sht3xDriver::Sht3xDriver(uint8_t address)
+    : address(address), measuring(false), startMillis(0), valid(false), temperature(NAN), humidity(NAN) {}
+
+//¤=======================================================================================¤
+
+bool Sht3xDriver::begin() {
+    Wire.begin();
+    Wire.beginTransmission(address);
+    return Wire.endTransmission() == 0;
+}
+
+bool Sht3xDriver::startMeasurement() {
+    if (measuring) {
+        return false;
+    }
+    measuring = sendCommand(SHT3X_MEASURE_HIGH_REPEATABILITY);
+    startMillis = millis();
+    valid = false;
+    return measuring;
+}
+
+bool Sht3xDriver::poll() {
+    if (!measuring || millis() - startMillis < SHT3X_CONVERSION_MILLIS) {
+        return false;
+    }
+    measuring = false;
+
+    uint8_t data[6];
+    if (Wire.requestFrom(address, (uint8_t)6) != 6) {
+        return true;
+    }
+    for (int i = 0; i < 6; i++) {
+        data[i] = Wire.read();
+    }
+
+    if (sensirionCrc8(data, 2) != data[2] || sensirionCrc8(data + 3, 2) != data[5]) {
+        return true;
+    }
+
+    uint16_t rawTemperature = (data[0] << 8) | data[1];
+    uint16_t rawHumidity = (data[3] << 8) | data[4];
+    temperature = -45.0f + 175.0f * rawTemperature / 65535.0f;
+    humidity = 100.0f * rawHumidity / 65535.0f;
+    valid = true;
+    return true;
+}
+
+bool Sht3xDriver::read(SensorReading& reading) {
+    if (!valid) {
+        return false;
+    }
+    reading.set(CHANNEL_TEMPERATURE, temperature);
+    reading.set(CHANNEL_HUMIDITY, humidity);
+    return true;
+}
+
+//¤=======================================================================================¤
+
+bool Sht3xDriver::sendCommand(uint16_t command) {
+    Wire.beginTransmission(address);
+    Wire.write((uint8_t)(command >> 8));
+    Wire.write((uint8_t)(command & 0xFF));
+    return Wire.endTransmission() == 0;
+}
@@ -0,0 +1,29 @@
+#ifndef SHT3X_DRIVER_H
+#define SHT3X_DRIVER_H
+
+#include <Wire.h>
+#include "../config/Config.h"
+#include "../sensors/SensorDriver.h"
+
+// Sensirion SHT3x on I2C, single-shot high repeatability mode
+class Sht3xDriver : public SensorDriver {
+  public:
+    Sht3xDriver(uint8_t address);
+    const char* getName() override { return "SHT3x"; }
+    bool begin() override;
+    bool startMeasurement() override;
+    bool poll() override;
+    bool read(SensorReading& reading) override;
+    unsigned long getMinSamplingPeriod() override { return 1000; }
+
+  private:
+    uint8_t address;
+    bool measuring;
+    unsigned long startMillis;
+    bool valid;
+    float temperature;
+    float humidity;
+    bool sendCommand(uint16_t command);
+};
+
+#endif // SHT3X_DRIVER_H
@@ -0,0 +1,123 @@
+#include "SoundLevelDriver.h"
+
+SoundLevelDriver* SoundLevelDriver::instance = nullptr;
+volatile bool SoundLevelDriver::adcClaimed = false;
+
+SoundLevelDriver::SoundLevelDriver(int pin)
+    : pin(pin), fillingBuffer(0), sampleIndex(0), lastSample(0), conversionStarted(false), adcChannelMask{0, 0},
+      adcChannel(0), readyBuffer(-1), droppedBlocks(0), isrMicros(0),
+      energySum(0.0f), blockCount(0), processMicros(0), periodStartMicros(0), cpuLoad(0.0f) {}
+
+//¤=======================================================================================¤
+
+bool SoundLevelDriver::begin() {
+    instance = this;
+    pinMode(pin, INPUT);
+
+    // One blocking read lets the core set up the ADC and the pin, the interrupt then only
+    // restarts the scan. The selection it leaves behind names the pin's channel
+    analogRead(pin);
+    adcChannelMask[0] = R_ADC0->ADANSA[0];
+    adcChannelMask[1] = R_ADC0->ADANSA[1];
+    adcChannel = 0;
+    while (adcChannel < 31 && !((adcChannelMask[adcChannel / 16] >> (adcChannel % 16)) & 1)) {
+        adcChannel++;
+    }
+
+    uint8_t timerType;
+    int8_t timerChannel = FspTimer::get_available_timer(timerType);
+    if (timerChannel < 0) {
+        return false;
+    }
+
+    if (!timer.begin(TIMER_MODE_PERIODIC, timerType, timerChannel, SOUND_SAMPLE_RATE, 0.0f, handleSampleTimer) ||
+        !timer.setup_overflow_irq() || !timer.open()) {
+        return false;
+    }
+
+    periodStartMicros = micros();
+    return timer.start();
+}
+
+//¤=======================================================================================¤
+
+void SoundLevelDriver::process() {
+    if (readyBuffer < 0) {
+        return;
+    }
+
+    unsigned long startMicros = micros();
+    int buffer = readyBuffer;
+    readyBuffer = -1;
+
+    // The interrupt is filling the other half, this one stays put until the next swap
+    energySum += filter.meanSquare((const uint16_t*)buffers[buffer], SOUND_BLOCK_SIZE);
+    blockCount++;
+
+    processMicros += micros() - startMicros;
+}
+
+//¤=======================================================================================¤
+
+bool SoundLevelDriver::read(SensorReading& reading) {
+    unsigned long elapsed = micros() - periodStartMicros;
+    if (elapsed > 0) {
+        cpuLoad = (float)(processMicros + isrMicros) / elapsed;
+    }
+    periodStartMicros = micros();
+    processMicros = 0;
+    isrMicros = 0;
+
+    if (blockCount == 0) {
+        return false;
+    }
+
+    // Leq is the level of the average energy, not the average of the levels
+    float meanSquare = energySum / blockCount;
+    energySum = 0.0f;
+    blockCount = 0;
+    if (meanSquare <= 0.0f) {
+        return false;
+    }
+
+    reading.set(CHANNEL_SOUND_LEVEL, 10.0f * log10f(meanSquare) + SOUND_CALIBRATION_OFFSET);
+    return true;
+}
+
+//¤=======================================================================================¤
+
+void SoundLevelDriver::handleSampleTimer(timer_callback_args_t* args) {
+    SoundLevelDriver* driver = instance;
+    unsigned long startMicros = micros();
+
+    // Never wait for the ADC here: collect the conversion started one tick (125 µs) ago and
+    // start the next one. A blocking analogRead() held the CPU for tens of microseconds,
+    // enough to shift the DHT22 edge timestamps. The loop owns the ADC for a moment,
+    // hold the last sample so the rate stays fixed
+    if (adcClaimed) {
+        driver->conversionStarted = false;
+    } else {
+        if (driver->conversionStarted) {
+            driver->lastSample = R_ADC0->ADDR[driver->adcChannel];
+        }
+        // Another user may have selected its own channel since
+        R_ADC0->ADANSA[0] = driver->adcChannelMask[0];
+        R_ADC0->ADANSA[1] = driver->adcChannelMask[1];
+        R_ADC0->ADCSR_b.ADST = 1;
+        driver->conversionStarted = true;
+    }
+    driver->buffers[driver->fillingBuffer][driver->sampleIndex] = driver->lastSample;
+    driver->sampleIndex++;
+
+    // Swap halves when one is full and hand the finished one to process()
+    if (driver->sampleIndex >= SOUND_BLOCK_SIZE) {
+        if (driver->readyBuffer >= 0) {
+            driver->droppedBlocks++;
+        }
+        driver->readyBuffer = driver->fillingBuffer;
+        driver->fillingBuffer ^= 1;
+        driver->sampleIndex = 0;
+    }
+
+    driver->isrMicros += micros() - startMicros;
+}
@@ -0,0 +1,57 @@
+#ifndef SOUND_LEVEL_DRIVER_H
+#define SOUND_LEVEL_DRIVER_H
+
+#include <FspTimer.h>
+#include "../config/Config.h"
+#include "../sensors/SensorDriver.h"
+#include "../utils/AWeightingFilter.h"
+
+// Analog microphone sampled at a fixed rate from a timer interrupt into a
+// ping-pong buffer. Finished blocks are A-weighted in process(), and read()
+// reports the equivalent continuous level (Leq) since the previous read.
+class SoundLevelDriver : public SensorDriver {
+  public:
+    SoundLevelDriver(int pin);
+    const char* getName() override { return "Sound"; }
+    bool begin() override; // Starts the sample timer
+    bool startMeasurement() override { return true; } // Sampling runs all the time
+    bool poll() override { return true; }
+    bool read(SensorReading& reading) override; // Leq since the last read, false when no block was processed
+    unsigned long getMinSamplingPeriod() override { return 0; }
+    void process(); // Call every loop pass, filters the finished block
+    float getCpuLoad() { return cpuLoad; } // Share of time spent sampling and filtering over the last read period (0-1)
+    unsigned long getDroppedBlocks() { return droppedBlocks; }
+    // Other ADC users claim it around a conversion instead of masking interrupts,
+    // the sample interrupt repeats its last value while the ADC is claimed.
+    // Waits out a conversion the interrupt started, a microsecond at most
+    static void claimAdc() {
+        adcClaimed = true;
+        while (R_ADC0->ADCSR_b.ADST) {}
+    }
+    static void releaseAdc() { adcClaimed = false; }
+
+  private:
+    static SoundLevelDriver* instance;
+    static volatile bool adcClaimed;
+    static void handleSampleTimer(timer_callback_args_t* args);
+    int pin;
+    FspTimer timer;
+    volatile uint16_t buffers[2][SOUND_BLOCK_SIZE];
+    volatile uint8_t fillingBuffer;
+    volatile int sampleIndex;
+    volatile uint16_t lastSample;
+    volatile bool conversionStarted; // The interrupt started a conversion on its previous tick
+    uint16_t adcChannelMask[2]; // Scan selection (ADANSA) for the pin, taken from a configuring analogRead()
+    int adcChannel;
+    volatile int8_t readyBuffer; // -1 while no finished block waits
+    volatile unsigned long droppedBlocks; // Blocks overwritten before process() got to them
+    volatile unsigned long isrMicros; // Time spent in the sample interrupt
+    AWeightingFilter filter;
+    float energySum; // Sum of the block mean squares since the last read
+    unsigned long blockCount;
+    unsigned long processMicros;
+    unsigned long periodStartMicros;
+    float cpuLoad;
+};
+
+#endif // SOUND_LEVEL_DRIVER_H
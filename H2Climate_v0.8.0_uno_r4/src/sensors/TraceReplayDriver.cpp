@@ -0,0 +1,86 @@
+#include "TraceReplayDriver.h"
+
+TraceReplayDriver::TraceReplayDriver(const char* trace)
+    : trace(trace), firstRow(nullptr), nextRow(nullptr), startMillis(0), firstTimestamp(0), wrapOffset(0) {
+    current = { 0, NAN, NAN, NAN };
+}
+
+//¤=======================================================================================¤
+
+bool TraceReplayDriver::begin() {
+    const char* position = trace;
+    if (!parseRow(position, current)) {
+        return false;
+    }
+
+    firstRow = trace;
+    nextRow = position;
+    startMillis = millis();
+    firstTimestamp = current.timestamp;
+    wrapOffset = 0;
+    return true;
+}
+
+//¤=======================================================================================¤
+
+bool TraceReplayDriver::read(SensorReading& reading) {
+    if (nextRow == nullptr) {
+        return false;
+    }
+
+    // Seconds of trace time since the replay started, relative to the first row
+    unsigned long virtualSeconds = (unsigned long)((uint64_t)(millis() - startMillis) * TRACE_REPLAY_SPEEDUP / 1000);
+
+    // Skip every row that is already in the past, wrapping around at the end of the trace
+    TraceRow row;
+    const char* position = nextRow;
+    while (true) {
+        if (!parseRow(position, row)) {
+            wrapOffset += current.timestamp - firstTimestamp + 1;
+            position = firstRow;
+            continue;
+        }
+        if (row.timestamp - firstTimestamp + wrapOffset > virtualSeconds) {
+            break;
+        }
+        current = row;
+        nextRow = position;
+    }
+
+    reading.set(CHANNEL_TEMPERATURE, current.temperature);
+    reading.set(CHANNEL_HUMIDITY, current.humidity);
+    return true;
+}
+
+//¤=======================================================================================¤
+
+bool TraceReplayDriver::parseRow(const char*& position, TraceRow& row) {
+    while (*position != '\0') {
+        // Skip comments, headers and empty lines
+        if (*position < '0' || *position > '9') {
+            while (*position != '\0' && *position != '\n') {
+                position++;
+            }
+            if (*position == '\n') {
+                position++;
+            }
+            continue;
+        }
+
+        char* end;
+        row.timestamp = strtoul(position, &end, 10);
+        row.temperature = *end == ',' ? strtod(end + 1, &end) : NAN;
+        row.humidity = *end == ',' ? strtod(end + 1, &end) : NAN;
+        row.battery = *end == ',' ? strtod(end + 1, &end) : NAN;
+
+        position = end;
+        while (*position != '\0' && *position != '\n') {
+            position++;
+        }
+        if (*position == '\n') {
+            position++;
+        }
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,42 @@
+#ifndef TRACE_REPLAY_DRIVER_H
+#define TRACE_REPLAY_DRIVER_H
+
+#include "../config/Config.h"
+#include "../sensors/SensorDriver.h"
+
+// Replays a CSV trace of "timestamp,temperature,humidity,battery" rows (seconds,
+// °C, %, battery pin voltage) in place of the real sensors. Trace time runs
+// TRACE_REPLAY_SPEEDUP times faster than real time and wraps at the end, and the
+// rows are parsed in place from flash without copying the trace.
+class TraceReplayDriver : public SensorDriver {
+  public:
+    TraceReplayDriver(const char* trace);
+    const char* getName() override { return "Trace"; }
+    bool begin() override; // Returns false when the trace has no rows
+    bool startMeasurement() override { return true; }
+    bool poll() override { return true; }
+    bool read(SensorReading& reading) override; // Row at the current virtual time
+    unsigned long getMinSamplingPeriod() override { return 0; }
+    float getBatteryVoltage() { return current.battery; } // NAN when the trace has no battery column
+
+    struct TraceRow {
+      unsigned long timestamp;
+      float temperature;
+      float humidity;
+      float battery;
+    };
+    // Parses the next row at position and moves past it, false at the end of the trace.
+    // Shared with the host replay, which runs traces on a virtual clock
+    static bool parseRow(const char*& position, TraceRow& row);
+
+  private:
+    const char* trace;
+    const char* firstRow;
+    const char* nextRow; // Start of the row after current
+    TraceRow current;
+    unsigned long startMillis;
+    unsigned long firstTimestamp; // Traces may use Unix time or start at zero
+    unsigned long wrapOffset; // Virtual seconds replayed in earlier passes
+};
+
+#endif // TRACE_REPLAY_DRIVER_H
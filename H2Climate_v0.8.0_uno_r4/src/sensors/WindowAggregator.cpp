@@ -0,0 +1,97 @@
+#include "WindowAggregator.h"
+
+WindowAggregator::WindowAggregator()
+    : windowLength(AGGREGATION_WINDOW) {
+    reset();
+}
+
+//¤=======================================================================================¤
+
+void WindowAggregator::add(const SensorReading& reading, time_t timestamp, unsigned long currentMillis) {
+    if (!windowOpen) {
+        windowOpen = true;
+        windowStartMillis = currentMillis;
+        startTimestamp = timestamp;
+    }
+    endTimestamp = timestamp;
+
+    for (int channel = 0; channel < SENSOR_CHANNEL_COUNT; channel++) {
+        if (!reading.has((SensorChannel)channel)) {
+            continue;
+        }
+
+        float value = reading.values[channel];
+        ChannelState& state = channels[channel];
+
+        if (state.count == 0 || value < state.min) {
+            state.min = value;
+        }
+        if (state.count == 0 || value > state.max) {
+            state.max = value;
+        }
+
+        // Welford update
+        state.count++;
+        float delta = value - state.mean;
+        state.mean += delta / state.count;
+        state.m2 += delta * (value - state.mean);
+
+        if (channel == CHANNEL_SOUND_LEVEL) {
+            state.energy += powf(10.0f, value / 10.0f);
+        }
+    }
+}
+
+bool WindowAggregator::isWindowDue(unsigned long currentMillis) {
+    return windowOpen && currentMillis - windowStartMillis >= windowLength;
+}
+
+unsigned long WindowAggregator::getMillisUntilDue(unsigned long currentMillis) {
+    // The next sample opens a closed window, so a full window is the soonest it can be due
+    if (!windowOpen) {
+        return windowLength;
+    }
+    unsigned long elapsed = currentMillis - windowStartMillis;
+    return elapsed >= windowLength ? 0 : windowLength - elapsed;
+}
+
+void WindowAggregator::takeSummary(WindowSummary& summary) {
+    summary.startTimestamp = startTimestamp;
+    summary.endTimestamp = endTimestamp;
+    summary.channelMask = 0;
+
+    for (int channel = 0; channel < SENSOR_CHANNEL_COUNT; channel++) {
+        ChannelState& state = channels[channel];
+        ChannelSummary& out = summary.channels[channel];
+        out.count = state.count;
+        if (state.count == 0) {
+            continue;
+        }
+
+        summary.channelMask |= (1 << channel);
+        out.min = state.min;
+        out.max = state.max;
+        out.mean = state.mean;
+        if (channel == CHANNEL_SOUND_LEVEL) {
+            out.mean = 10.0f * log10f(state.energy / state.count); // Leq of the window
+        }
+        out.stddev = state.count > 1 ? sqrtf(state.m2 / (state.count - 1)) : 0.0f;
+    }
+
+    reset();
+}
+
+//¤=======================================================================================¤
+
+void WindowAggregator::reset() {
+    for (int channel = 0; channel < SENSOR_CHANNEL_COUNT; channel++) {
+        channels[channel].count = 0;
+        channels[channel].mean = 0.0f;
+        channels[channel].m2 = 0.0f;
+        channels[channel].energy = 0.0f;
+    }
+    windowOpen = false;
+    windowStartMillis = 0;
+    startTimestamp = 0;
+    endTimestamp = 0;
+}
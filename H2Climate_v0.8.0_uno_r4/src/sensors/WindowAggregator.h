@@ -0,0 +1,53 @@
+#ifndef WINDOW_AGGREGATOR_H
+#define WINDOW_AGGREGATOR_H
+
+#include "../config/Config.h"
+#include "../sensors/SensorDriver.h"
+
+// Statistics of one channel over a window
+struct ChannelSummary {
+  uint16_t count;
+  float min;
+  float max;
+  float mean;
+  float stddev;
+};
+
+struct WindowSummary {
+  time_t startTimestamp; // Unix time of the first sample in the window
+  time_t endTimestamp; // Unix time of the last sample in the window
+  uint16_t channelMask; // Bit per channel that had at least one sample
+  ChannelSummary channels[SENSOR_CHANNEL_COUNT];
+};
+
+// Streaming per-channel min/max/mean/stddev over a time window. Variance uses
+// Welford's algorithm, so no samples are stored.
+class WindowAggregator {
+  public:
+    WindowAggregator();
+    void add(const SensorReading& reading, time_t timestamp, unsigned long currentMillis);
+    bool isWindowDue(unsigned long currentMillis); // True when the running window has reached its length
+    unsigned long getMillisUntilDue(unsigned long currentMillis);
+    void setWindowLength(unsigned long length) { windowLength = length; } // Applies to the running window too
+    unsigned long getWindowLength() { return windowLength; }
+    void takeSummary(WindowSummary& summary); // Copies the window out and starts a new one
+
+  private:
+    struct ChannelState {
+      uint16_t count;
+      float min;
+      float max;
+      float mean;
+      float m2; // Sum of squared differences from the running mean
+      float energy; // Sum of 10^(L/10), levels in dB are averaged by energy
+    };
+    ChannelState channels[SENSOR_CHANNEL_COUNT];
+    unsigned long windowLength;
+    unsigned long windowStartMillis;
+    time_t startTimestamp;
+    time_t endTimestamp;
+    bool windowOpen;
+    void reset();
+};
+
+#endif // WINDOW_AGGREGATOR_H
@@ -0,0 +1,130 @@
+#ifndef SYNTHETIC_OFFICE_TRACE_H
+#define SYNTHETIC_OFFICE_TRACE_H
+
+// Synthetic two-hour office morning for the trace replay driver, one row per minute.
+// Generated, not recorded: empty room until 08:30, occupied until 09:45, then empty.
+// Columns: seconds since start, temperature (°C), humidity (%), battery pin voltage (V)
+const char SYNTHETIC_OFFICE_TRACE[] =
+    "# timestamp,temperature,humidity,battery\n"
+    "0,20.95,37.80,0.662\n"
+    "60,20.97,37.87,0.662\n"
+    "120,20.98,37.93,0.662\n"
+    "180,21.00,38.00,0.661\n"
+    "240,21.02,38.07,0.661\n"
+    "300,21.03,38.13,0.661\n"
+    "360,21.05,38.20,0.661\n"
+    "420,20.96,37.83,0.661\n"
+    "480,20.98,37.90,0.660\n"
+    "540,20.99,37.97,0.660\n"
+    "600,21.01,38.03,0.660\n"
+    "660,21.02,38.10,0.660\n"
+    "720,21.04,38.17,0.660\n"
+    "780,20.95,37.80,0.659\n"
+    "840,20.97,37.87,0.659\n"
+    "900,20.98,37.93,0.659\n"
+    "960,21.00,38.00,0.659\n"
+    "1020,21.02,38.07,0.659\n"
+    "1080,21.03,38.13,0.658\n"
+    "1140,21.05,38.20,0.658\n"
+    "1200,20.96,37.83,0.658\n"
+    "1260,20.98,37.90,0.658\n"
+    "1320,20.99,37.97,0.658\n"
+    "1380,21.01,38.03,0.657\n"
+    "1440,21.02,38.10,0.657\n"
+    "1500,21.04,38.17,0.657\n"
+    "1560,20.95,37.80,0.657\n"
+    "1620,20.97,37.87,0.657\n"
+    "1680,20.98,37.93,0.656\n"
+    "1740,21.00,38.00,0.656\n"
+    "1800,21.02,38.07,0.656\n"
+    "1860,21.11,38.52,0.656\n"
+    "1920,21.20,38.95,0.656\n"
+    "1980,21.18,38.92,0.655\n"
+    "2040,21.27,39.30,0.655\n"
+    "2100,21.35,39.67,0.655\n"
+    "2160,21.44,40.01,0.655\n"
+    "2220,21.51,40.34,0.655\n"
+    "2280,21.59,40.65,0.654\n"
+    "2340,21.55,40.51,0.654\n"
+    "2400,21.63,40.79,0.654\n"
+    "2460,21.70,41.05,0.654\n"
+    "2520,21.76,41.30,0.654\n"
+    "2580,21.83,41.54,0.653\n"
+    "2640,21.89,41.77,0.653\n"
+    "2700,21.95,41.99,0.653\n"
+    "2760,21.90,41.77,0.653\n"
+    "2820,21.96,41.97,0.653\n"
+    "2880,22.02,42.16,0.652\n"
+    "2940,22.07,42.34,0.652\n"
+    "3000,22.13,42.52,0.652\n"
+    "3060,22.18,42.69,0.652\n"
+    "3120,22.12,42.42,0.652\n"
+    "3180,22.17,42.57,0.651\n"
+    "3240,22.22,42.72,0.651\n"
+    "3300,22.26,42.87,0.651\n"
+    "3360,22.31,43.01,0.651\n"
+    "3420,22.35,43.14,0.651\n"
+    "3480,22.40,43.27,0.650\n"
+    "3540,22.33,42.97,0.650\n"
+    "3600,22.37,43.09,0.650\n"
+    "3660,22.41,43.21,0.650\n"
+    "3720,22.45,43.32,0.650\n"
+    "3780,22.49,43.44,0.649\n"
+    "3840,22.53,43.54,0.649\n"
+    "3900,22.46,43.22,0.649\n"
+    "3960,22.49,43.32,0.649\n"
+    "4020,22.53,43.42,0.649\n"
+    "4080,22.56,43.52,0.648\n"
+    "4140,22.60,43.62,0.648\n"
+    "4200,22.63,43.72,0.648\n"
+    "4260,22.66,43.81,0.648\n"
+    "4320,22.59,43.47,0.648\n"
+    "4380,22.62,43.56,0.647\n"
+    "4440,22.65,43.65,0.647\n"
+    "4500,22.68,43.73,0.647\n"
+    "4560,22.71,43.82,0.647\n"
+    "4620,22.74,43.91,0.647\n"
+    "4680,22.66,43.56,0.646\n"
+    "4740,22.68,43.64,0.646\n"
+    "4800,22.71,43.72,0.646\n"
+    "4860,22.74,43.80,0.646\n"
+    "4920,22.77,43.88,0.646\n"
+    "4980,22.79,43.96,0.645\n"
+    "5040,22.82,44.04,0.645\n"
+    "5100,22.74,43.68,0.645\n"
+    "5160,22.76,43.76,0.645\n"
+    "5220,22.79,43.83,0.645\n"
+    "5280,22.81,43.91,0.644\n"
+    "5340,22.84,43.98,0.644\n"
+    "5400,22.86,44.06,0.644\n"
+    "5460,22.78,43.70,0.644\n"
+    "5520,22.80,43.77,0.644\n"
+    "5580,22.82,43.84,0.643\n"
+    "5640,22.85,43.92,0.643\n"
+    "5700,22.87,43.99,0.643\n"
+    "5760,22.89,44.06,0.643\n"
+    "5820,22.91,44.13,0.643\n"
+    "5880,22.83,43.77,0.642\n"
+    "5940,22.85,43.84,0.642\n"
+    "6000,22.87,43.91,0.642\n"
+    "6060,22.89,43.98,0.642\n"
+    "6120,22.91,44.05,0.642\n"
+    "6180,22.93,44.12,0.641\n"
+    "6240,22.85,43.76,0.641\n"
+    "6300,22.87,43.83,0.641\n"
+    "6360,22.84,43.60,0.641\n"
+    "6420,22.81,43.39,0.641\n"
+    "6480,22.78,43.20,0.640\n"
+    "6540,22.75,43.01,0.640\n"
+    "6600,22.73,42.84,0.640\n"
+    "6660,22.59,42.25,0.640\n"
+    "6720,22.57,42.10,0.640\n"
+    "6780,22.55,41.96,0.639\n"
+    "6840,22.53,41.83,0.639\n"
+    "6900,22.51,41.71,0.639\n"
+    "6960,22.49,41.61,0.639\n"
+    "7020,22.36,41.07,0.639\n"
+    "7080,22.34,40.98,0.638\n"
+    "7140,22.32,40.89,0.638\n";
+
+#endif // SYNTHETIC_OFFICE_TRACE_H
@@ -0,0 +1,49 @@
+#include "AWeightingFilter.h"
+
+// b0, b1, b2, a1, a2 per section, a0 = 1. Poles at 20.6 Hz (double), 107.7 Hz, 737.9 Hz
+// and 12194 Hz (double), zeros at DC and Nyquist. Within 0.3 dB of the standard curve
+// from 31.5 Hz to 2 kHz, above that the bilinear warping rolls off towards 4 kHz.
+const float A_WEIGHTING_COEFFICIENTS[A_WEIGHTING_SECTIONS][5] = {
+    { 1.0f, -2.0f, 1.0f, -1.96790281f, 0.968160369f },
+    { 1.0f, -2.0f, 1.0f, -1.46955791f, 0.506007216f },
+    { 0.619348734f, 1.23869747f, 0.619348734f, 1.30899353f, 0.428366016f }
+};
+
+AWeightingFilter::AWeightingFilter() {
+    reset();
+}
+
+void AWeightingFilter::reset() {
+    for (int section = 0; section < A_WEIGHTING_SECTIONS; section++) {
+        state[section][0] = 0.0f;
+        state[section][1] = 0.0f;
+    }
+}
+
+float AWeightingFilter::meanSquare(const uint16_t* samples, int count) {
+    if (count <= 0) {
+        return 0.0f;
+    }
+
+    // Remove the microphone bias first, so the filter only sees the AC part
+    uint32_t sum = 0;
+    for (int i = 0; i < count; i++) {
+        sum += samples[i];
+    }
+    float offset = (float)sum / count;
+
+    float energy = 0.0f;
+    for (int i = 0; i < count; i++) {
+        float value = samples[i] - offset;
+        for (int section = 0; section < A_WEIGHTING_SECTIONS; section++) {
+            const float* c = A_WEIGHTING_COEFFICIENTS[section];
+            float* z = state[section];
+            float output = c[0] * value + z[0];
+            z[0] = c[1] * value - c[3] * output + z[1];
+            z[1] = c[2] * value - c[4] * output;
+            value = output;
+        }
+        energy += value * value;
+    }
+    return energy / count;
+}
@@ -0,0 +1,22 @@
+#ifndef A_WEIGHTING_FILTER_H
+#define A_WEIGHTING_FILTER_H
+
+#include <stdint.h>
+
+// Number of second order sections in the A-weighting cascade
+const int A_WEIGHTING_SECTIONS = 3;
+
+// IEC 61672 A-weighting for an 8 kHz sample rate as three biquads (bilinear
+// transform of the analog filter, 0 dB at 1 kHz). Plain C++ without Arduino
+// dependencies, so the kernel builds on the host as well.
+class AWeightingFilter {
+  public:
+    AWeightingFilter();
+    void reset();
+    float meanSquare(const uint16_t* samples, int count); // Weighted mean square of one block, in ADC counts squared
+
+  private:
+    float state[A_WEIGHTING_SECTIONS][2]; // Transposed direct form II delay line
+};
+
+#endif // A_WEIGHTING_FILTER_H
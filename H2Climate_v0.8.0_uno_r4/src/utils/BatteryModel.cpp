@@ -0,0 +1,50 @@
+#include "BatteryModel.h"
+
+float batteryStateOfCharge(float batteryVoltage, float temperature) {
+    // Battery voltage as it would read at 25 °C
+    float voltage = batteryVoltage + BATTERY_TEMPERATURE_COEFFICIENT * (25.0f - temperature);
+
+    if (voltage >= BATTERY_CURVE_VOLTAGE[0]) {
+        return BATTERY_CURVE_PERCENT[0];
+    }
+    for (int i = 1; i < BATTERY_CURVE_POINTS; i++) {
+        if (voltage >= BATTERY_CURVE_VOLTAGE[i]) {
+            float fraction = (voltage - BATTERY_CURVE_VOLTAGE[i]) / (BATTERY_CURVE_VOLTAGE[i - 1] - BATTERY_CURVE_VOLTAGE[i]);
+            return BATTERY_CURVE_PERCENT[i] + fraction * (BATTERY_CURVE_PERCENT[i - 1] - BATTERY_CURVE_PERCENT[i]);
+        }
+    }
+    return BATTERY_CURVE_PERCENT[BATTERY_CURVE_POINTS - 1];
+}
+
+//¤=======================================================================================¤
+
+DrainTrend::DrainTrend()
+    : count(0), next(0), lastMillis(0), rate(NAN) {}
+
+void DrainTrend::add(float charge, unsigned long currentMillis) {
+    lastMillis = currentMillis;
+    percents[next] = charge;
+    times[next] = currentMillis;
+    next = (next + 1) % BATTERY_TREND_POINTS;
+    if (count < BATTERY_TREND_POINTS) {
+        count++;
+    }
+    if (count < BATTERY_TREND_MIN_POINTS) {
+        return;
+    }
+
+    // Least-squares slope of charge over time, hours since the oldest point keep the sums small
+    unsigned long oldest = times[count < BATTERY_TREND_POINTS ? 0 : next];
+    float sumX = 0.0f, sumY = 0.0f, sumXX = 0.0f, sumXY = 0.0f;
+    for (int i = 0; i < count; i++) {
+        float hours = (times[i] - oldest) / 3600000.0f;
+        sumX += hours;
+        sumY += percents[i];
+        sumXX += hours * hours;
+        sumXY += hours * percents[i];
+    }
+    float denominator = count * sumXX - sumX * sumX;
+    if (denominator > 0.0f) {
+        rate = -(count * sumXY - sumX * sumY) / denominator;
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef BATTERY_MODEL_H
+#define BATTERY_MODEL_H
+
+#include "../config/Config.h"
+
+// Remaining charge in percent from the battery voltage, using the discharge curve
+// in Config.h shifted to its 25 °C equivalent
+float batteryStateOfCharge(float batteryVoltage, float temperature);
+
+// Least-squares drain rate over a rolling history of charge readings, one point
+// per BATTERY_TREND_INTERVAL
+class DrainTrend {
+  public:
+    DrainTrend();
+    bool isPointDue(unsigned long currentMillis) { return count == 0 || currentMillis - lastMillis >= BATTERY_TREND_INTERVAL; }
+    void add(float charge, unsigned long currentMillis);
+    float getRate() { return rate; } // Percent per hour, NAN until BATTERY_TREND_MIN_POINTS
+
+  private:
+    float percents[BATTERY_TREND_POINTS];
+    unsigned long times[BATTERY_TREND_POINTS];
+    int count;
+    int next;
+    unsigned long lastMillis;
+    float rate;
+};
+
+#endif // BATTERY_MODEL_H
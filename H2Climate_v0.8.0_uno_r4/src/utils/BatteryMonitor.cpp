@@ -1,7 +1,18 @@
 #include "BatteryMonitor.h"
+#include "../sensors/SoundLevelDriver.h"
 
 BatteryMonitor::BatteryMonitor(FancyLog& fancyLog)
-    : fancyLog(fancyLog) {}
+    : fancyLog(fancyLog), voltage(0.0), percentage(0), timeRemaining(0), ambientTemperature(25.0), lastSampleMillis(0),
+      lastReadMicros(0) {}
+
+// The sound driver samples the ADC from a timer interrupt, claim the ADC instead of
+// masking interrupts, so the DHT22 edge interrupt keeps running during the conversion
+static int readBatteryPin() {
+    SoundLevelDriver::claimAdc();
+    int value = analogRead(BATTERY_PIN);
+    SoundLevelDriver::releaseAdc();
+    return value;
+}
 
 //¤=======================================================================================¤
 
@@ -11,24 +22,32 @@ void BatteryMonitor::begin() {
 
     // Initialize battery monitoring pin
     pinMode(BATTERY_PIN, INPUT);
-    
-    // Take an initial reading
-    logStatus();
+
+    // Seed the filter, one oversampled read takes well under a millisecond
+    voltage = readVoltage();
+    lastSampleMillis = millis();
+    float charge = stateOfCharge(voltage);
+    trend.add(charge, lastSampleMillis);
+    percentage = (int)lroundf(charge);
+    timeRemaining = estimateTimeRemaining(percentage);
+}
+
+void BatteryMonitor::update(unsigned long currentMillis) {
+    if (currentMillis - lastSampleMillis >= BATTERY_SAMPLE_PERIOD) {
+        sample(currentMillis);
+    }
 }
 
 //¤=======================================================================================¤
 
 void BatteryMonitor::logStatus() {
-    // Log the current battery status
-    float voltage = readVoltage();
-    int percentage = readPercentage(voltage);
-    int timeRemaining = estimateTimeRemaining(percentage);
-
+    // Log the cached battery status
     fancyLog.toSerial("Battery reading: " +
 			   String(voltage, 2) + "V (actual ~" +
                String(voltage * VOLTAGE_TO_BATTERY, 1) + "V, " +
                String(percentage) + "%) - Est. " +
-			   String(timeRemaining) + " minutes remaining", INFO);
+			   String(timeRemaining) + " minutes remaining (read in " +
+               String(lastReadMicros) + " us)", INFO);
 
     // Show low battery warning if below threshold
     if (isLowBattery()) {
@@ -38,84 +57,57 @@ void BatteryMonitor::logStatus() {
 
 //¤=======================================================================================¤
 
-float BatteryMonitor::readVoltage() {
-    // Read the analog value from the battery pin
-    int rawValue = analogRead(BATTERY_PIN);
-    
-    // Add some smoothing by taking multiple readings
-    for (int i = 0; i < 10; i++) {
-        rawValue = (rawValue + analogRead(BATTERY_PIN)) / 2;
-        delay(1);
-    }
-
-	// Convert to voltage (The ADC is set to 14-bit resolution with 3.3V reference)
-    float voltage = rawValue * (3.3 / 16383.0);
+void BatteryMonitor::sample(unsigned long currentMillis) {
+    lastSampleMillis = currentMillis;
 
-    return voltage;
+    // The battery moves over hours, smoothing only removes load and ADC noise
+    voltage += BATTERY_FILTER_ALPHA * (readVoltage() - voltage);
+    float charge = stateOfCharge(voltage);
+    if (trend.isPointDue(lastSampleMillis)) {
+        trend.add(charge, lastSampleMillis);
+    }
+    percentage = (int)lroundf(charge);
+    timeRemaining = estimateTimeRemaining(percentage);
 }
 
 //¤=======================================================================================¤
 
-int BatteryMonitor::readPercentage() {
-    // Get current battery voltage
-    float voltage = readVoltage();
-    
-    // Calculate percentage based on calibrated voltage range
-    // Multiply by 1000 to maintain precision in the map function
-    long percentageCalc = map(
-        (long)(voltage * 1000), 
-        (long)(CALIBRATED_EMPTY_VOLTAGE * 1000), 
-        (long)(CALIBRATED_FULL_VOLTAGE * 1000), 
-        0, 
-        100
-    );
-    
-    // Constrain to 0-100 range
-    int percentage = constrain(percentageCalc, 0, 100);
-    
-    return percentage;
-}
+float BatteryMonitor::readVoltage() {
+    unsigned long startMicros = micros();
 
-// Overloaded function to read percentage with voltage parameter
-int BatteryMonitor::readPercentage(float voltage) {
-    // Calculate percentage based on calibrated voltage range
-    // Multiply by 1000 to maintain precision in the map function
-    long percentageCalc = map(
-        (long)(voltage * 1000),
-        (long)(CALIBRATED_EMPTY_VOLTAGE * 1000),
-        (long)(CALIBRATED_FULL_VOLTAGE * 1000),
-        0,
-        100
-    );
-
-    // Constrain to 0-100 range
-    int percentage = constrain(percentageCalc, 0, 100);
-
-    return percentage;
+    // True mean of back-to-back conversions, every sample weighs the same
+    uint32_t sum = 0;
+    for (int i = 0; i < BATTERY_OVERSAMPLE_COUNT; i++) {
+        sum += readBatteryPin();
+    }
+
+	// Convert to voltage (The ADC is set to 14-bit resolution with 3.3V reference)
+    // The mean stays fractional, so the extra bits from oversampling are kept
+    float rawValue = (float)sum / BATTERY_OVERSAMPLE_COUNT;
+    float pinVoltage = rawValue * (3.3 / 16383.0);
+
+    lastReadMicros = micros() - startMicros;
+
+    return pinVoltage;
 }
 
 //¤=======================================================================================¤
 
-int BatteryMonitor::estimateTimeRemaining() {
-    // Get current battery percentage
-    int percentage = readPercentage();
-    
-    // Estimate time remaining based on percentage of full battery life
-    int timeRemaining = (percentage * FULL_BATTERY_LIFE_MINUTES) / 100;
-    
-    return timeRemaining;
+int BatteryMonitor::readPercentage(float voltage) {
+    return (int)lroundf(stateOfCharge(voltage));
 }
 
-// Overloaded function to estimate time remaining with percentage parameter
-int BatteryMonitor::estimateTimeRemaining(int percentage) {
-    // Estimate time remaining based on percentage of full battery life
-    int timeRemaining = (percentage * FULL_BATTERY_LIFE_MINUTES) / 100;
-
-    return timeRemaining;
+float BatteryMonitor::stateOfCharge(float pinVoltage) {
+    return batteryStateOfCharge(pinVoltage * VOLTAGE_TO_BATTERY, ambientTemperature);
 }
 
 //¤=======================================================================================¤
 
-bool BatteryMonitor::isLowBattery() {
-    return readPercentage() < LOW_BATTERY_THRESHOLD;
+int BatteryMonitor::estimateTimeRemaining(int percentage) {
+    // Measured drain rate once there is enough history, the rated battery life until then
+    float drainRate = trend.getRate();
+    if (!isnan(drainRate) && drainRate > 0.0f) {
+        return (int)(percentage / drainRate * 60.0f);
+    }
+    return (percentage * FULL_BATTERY_LIFE_MINUTES) / 100;
 }
@@ -3,21 +3,39 @@
 
 #include "../config/Config.h"
 #include "../utils/FancyLog.h"
+#include "../utils/BatteryModel.h"
 
+// Battery state from one filtered sample per BATTERY_SAMPLE_PERIOD. The getters
+// serve the cached snapshot and never touch the ADC. Charge comes from the
+// discharge curve, time remaining from the measured drain rate.
 class BatteryMonitor {
   public:
     BatteryMonitor(FancyLog& fancyLog);
-    void begin();
+    void begin(); // Takes the first sample, so the snapshot is valid right away
+    void update(unsigned long currentMillis); // Call every loop pass, samples when the period is up
 	void logStatus();
-    float readVoltage(); // Returns estimated voltage
-	int readPercentage(); // If voltage is not provided, it will read the current voltage
-    int readPercentage(float voltage); // Returns estimated percentage
-	int estimateTimeRemaining(); // If percentage is not provided, it will read the current percentage
-    int estimateTimeRemaining(int percentage); // Returns estimated minutes remaining
-    bool isLowBattery();
+    void setTemperature(float temperature) { ambientTemperature = temperature; } // °C, for the curve compensation
+    float getVoltage() { return voltage; } // Filtered pin voltage
+    int getPercentage() { return percentage; }
+    int getTimeRemaining() { return timeRemaining; } // Minutes
+    bool isLowBattery() { return percentage < LOW_BATTERY_THRESHOLD; }
+    float getDrainRate() { return trend.getRate(); } // Percent per hour, NAN until enough history
+    int readPercentage(float voltage); // Converts a pin voltage, no ADC access
+    int estimateTimeRemaining(int percentage); // Converts a percentage to minutes
+    unsigned long getLastReadMicros() { return lastReadMicros; } // Duration of the last ADC sample
     
   private:
     FancyLog& fancyLog;
+    float voltage;
+    int percentage;
+    int timeRemaining;
+    float ambientTemperature;
+    unsigned long lastSampleMillis;
+    unsigned long lastReadMicros;
+    DrainTrend trend;
+    float readVoltage(); // Oversampled ADC read
+    void sample(unsigned long currentMillis);
+    float stateOfCharge(float pinVoltage); // Percent from the compensated discharge curve
 };
 
-#endif // BATTERY_MONITOR_H 
\ No newline at end of file
+#endif // BATTERY_MONITOR_H
@@ -0,0 +1,62 @@
+#include "DutyCyclePolicy.h"
+
+DutyCyclePolicy::DutyCyclePolicy()
+    : current(0), previous(0), chargeLevel(0), linkRssi(0), weakLink(false), changePending(false),
+      changeReason("battery") {}
+
+//¤=======================================================================================¤
+
+bool DutyCyclePolicy::update(int batteryPercentage, long rssi) {
+    if (!ENABLE_DUTY_CYCLING) {
+        return false;
+    }
+
+    // Richest policy the charge allows, moving back up needs a margin so a noisy reading does not flap
+    int previousChargeLevel = chargeLevel;
+    int level = DUTY_POLICY_COUNT - 1;
+    for (int i = 0; i < DUTY_POLICY_COUNT; i++) {
+        int threshold = DUTY_POLICY_MIN_PERCENT[i] + (i < chargeLevel ? DUTY_POLICY_HYSTERESIS : 0);
+        if (batteryPercentage >= threshold) {
+            level = i;
+            break;
+        }
+    }
+    chargeLevel = level;
+
+    // The RSSI is unknown while the radio is parked, the last reading stands in
+    if (rssi != 0) {
+        linkRssi = rssi;
+    }
+    if (linkRssi != 0) {
+        weakLink = linkRssi < DUTY_WEAK_LINK_RSSI + (weakLink ? DUTY_LINK_HYSTERESIS : 0);
+    }
+
+    int next = min(chargeLevel + (weakLink ? 1 : 0), DUTY_POLICY_COUNT - 1);
+    if (next == current) {
+        return false;
+    }
+    previous = current;
+    current = next;
+    changePending = true;
+    changeReason = chargeLevel != previousChargeLevel ? "battery" : "link";
+    return true;
+}
+
+//¤=======================================================================================¤
+
+bool DutyCyclePolicy::attachChange(JsonDocument& jsonDoc) {
+    if (!changePending) {
+        return false;
+    }
+
+    // The server rescales its silence timeout and expected sample rate from this
+    JsonObject policy = jsonDoc.createNestedObject("policy");
+    policy["name"] = getName();
+    policy["previous"] = DUTY_POLICY_NAME[previous];
+    policy["reason"] = changeReason;
+    policy["samplingSeconds"] = getSamplingInterval() / 1000;
+    policy["windowSeconds"] = getWindowLength() / 1000;
+    policy["heartbeatSeconds"] = getUploadInterval() / 1000;
+    policy["maxSilenceSeconds"] = (getUploadInterval() + getWindowLength()) / 1000; // Heartbeats wait for a window to close
+    return true;
+}
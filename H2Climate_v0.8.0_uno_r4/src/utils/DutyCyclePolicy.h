@@ -0,0 +1,34 @@
+#ifndef DUTY_CYCLE_POLICY_H
+#define DUTY_CYCLE_POLICY_H
+
+#include "../config/Config.h"
+
+// Picks a row of the duty policy table from the state of charge and the link
+// quality. A change stays pending until an upload carrying it went through.
+class DutyCyclePolicy {
+  public:
+    DutyCyclePolicy();
+    bool update(int batteryPercentage, long rssi); // True when the policy changed, rssi 0 keeps the last known
+    int getIndex() { return current; }
+    const char* getName() { return DUTY_POLICY_NAME[current]; }
+    unsigned long getSamplingInterval() { return DUTY_POLICY_SAMPLING_INTERVAL[current]; }
+    int getBatchSize() { return DUTY_POLICY_BATCH_SIZE[current]; }
+    unsigned long getWindowLength() { return getSamplingInterval() * getBatchSize(); }
+    unsigned long getUploadInterval() { return DUTY_POLICY_UPLOAD_INTERVAL[current]; }
+    bool allowsFastSampling() { return DUTY_POLICY_FAST_SAMPLING[current]; }
+    bool isWeakLink() { return weakLink; }
+    bool attachChange(JsonDocument& jsonDoc); // Adds a "policy" object while a change is unannounced
+    bool isChangePending() { return changePending; }
+    void clearChange() { changePending = false; } // Call once the upload carrying it succeeded
+
+  private:
+    int current;
+    int previous;
+    int chargeLevel; // Policy the charge alone allows
+    long linkRssi;
+    bool weakLink;
+    bool changePending;
+    const char* changeReason; // "battery" or "link"
+};
+
+#endif // DUTY_CYCLE_POLICY_H
@@ -0,0 +1,58 @@
+#include "PowerManager.h"
+
+PowerManager::PowerManager()
+    : markMicros(0), cycleStartMillis(0), activeMicros(0), sleepMicros(0), radioMicros(0), cycleEnergy(0.0),
+      averageCurrent(0.0), sleepPercent(0.0), cycleMillis(0) {}
+
+//¤=======================================================================================¤
+
+void PowerManager::idle(bool allowSleep, bool radioOn) {
+    // Everything since the last call was the loop pass itself
+    unsigned long now = micros();
+    unsigned long elapsed = now - markMicros;
+    activeMicros += elapsed;
+    if (radioOn) {
+        radioMicros += elapsed;
+    }
+
+    if (ENABLE_LOW_POWER && allowSleep) {
+        // Sleep mode keeps timers, ADC and UARTs clocked, so background work goes on.
+        // The millis tick bounds the nap to about a millisecond, software standby would
+        // stop that tick and every schedule in the loop with it
+        __WFI();
+        unsigned long slept = micros() - now;
+        sleepMicros += slept;
+        if (radioOn) {
+            radioMicros += slept;
+        }
+    }
+
+    markMicros = micros();
+}
+
+//¤=======================================================================================¤
+
+void PowerManager::closeCycle(float supplyVoltage, unsigned long currentMillis) {
+    cycleMillis = currentMillis - cycleStartMillis;
+    cycleStartMillis = currentMillis;
+
+    float seconds = (activeMicros + sleepMicros) / 1000000.0f;
+    if (seconds > 0.0f) {
+        float radioSeconds = radioMicros / 1000000.0f;
+        float radioCurrent = POWER_WIFI_MODEM_SLEEP ? POWER_RADIO_SLEEP_CURRENT : POWER_RADIO_CURRENT;
+
+        // Charge in mA*s, the board draws all the time, MCU and radio depend on their state
+        float charge = POWER_BOARD_CURRENT * seconds +
+                       POWER_MCU_ACTIVE_CURRENT * activeMicros / 1000000.0f +
+                       POWER_MCU_SLEEP_CURRENT * sleepMicros / 1000000.0f +
+                       radioCurrent * radioSeconds +
+                       POWER_RADIO_OFF_CURRENT * (seconds - radioSeconds);
+        averageCurrent = charge / seconds;
+        cycleEnergy = charge * supplyVoltage; // mA*s*V = mJ
+        sleepPercent = 100.0f * sleepMicros / (activeMicros + sleepMicros);
+    }
+
+    activeMicros = 0;
+    sleepMicros = 0;
+    radioMicros = 0;
+}
@@ -0,0 +1,30 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include "../config/Config.h"
+
+// Sleeps the MCU between loop passes and estimates the energy of each sampling
+// cycle from the time spent awake, asleep and with the radio up.
+class PowerManager {
+  public:
+    PowerManager();
+    void idle(bool allowSleep, bool radioOn); // Call once at the end of every loop pass
+    void closeCycle(float supplyVoltage, unsigned long currentMillis); // Call when a sampling cycle starts, closes the previous one
+    float getCycleEnergy() { return cycleEnergy; } // Millijoules used by the last cycle
+    float getAverageCurrent() { return averageCurrent; } // Milliamps over the last cycle
+    float getSleepPercent() { return sleepPercent; } // Share of the last cycle the MCU slept
+    unsigned long getCycleMillis() { return cycleMillis; }
+
+  private:
+    unsigned long markMicros; // Last time the running totals were brought up to date
+    unsigned long cycleStartMillis;
+    unsigned long activeMicros;
+    unsigned long sleepMicros;
+    unsigned long radioMicros;
+    float cycleEnergy;
+    float averageCurrent;
+    float sleepPercent;
+    unsigned long cycleMillis;
+};
+
+#endif // POWER_MANAGER_H
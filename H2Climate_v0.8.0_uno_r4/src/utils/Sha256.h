@@ -0,0 +1,23 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include "../config/Config.h"
+
+// Streaming SHA-256, used to verify firmware images without buffering them
+class Sha256 {
+  public:
+    Sha256();
+    void reset();
+    void update(const uint8_t* data, size_t len);
+    void finish(uint8_t digest[32]);
+    String finishHex(); // Lowercase hex digest, same format as the update manifest
+
+  private:
+    uint32_t state[8];
+    uint8_t block[64];
+    size_t blockLength;
+    uint64_t totalLength;
+    void transform();
+};
+
+#endif // SHA256_H
@@ -0,0 +1,53 @@
+#include "TestAssert.h"
+#include "../src/utils/AWeightingFilter.h"
+
+const double SAMPLE_RATE = 8000.0; // SOUND_SAMPLE_RATE, the coefficients are designed for it
+const int BLOCK_SIZE = 256;
+const int SETTLE_BLOCKS = 16; // Lets the 20 Hz poles ring down before measuring
+const int MEASURE_BLOCKS = 48;
+const double AMPLITUDE = 1000.0; // ADC counts around a 14-bit mid-scale bias
+
+// Gain in dB for a sine, block by block the way SoundLevelDriver::process() feeds it
+static double weightedGain(double frequency) {
+    AWeightingFilter filter;
+    uint16_t block[BLOCK_SIZE];
+    double energy = 0.0;
+    for (int b = 0; b < SETTLE_BLOCKS + MEASURE_BLOCKS; b++) {
+        for (int i = 0; i < BLOCK_SIZE; i++) {
+            int n = b * BLOCK_SIZE + i;
+            block[i] = (uint16_t)lround(8192.0 + AMPLITUDE * sin(2.0 * M_PI * frequency * n / SAMPLE_RATE));
+        }
+        float meanSquare = filter.meanSquare(block, BLOCK_SIZE);
+        if (b >= SETTLE_BLOCKS) {
+            energy += meanSquare;
+        }
+    }
+    return 10.0 * log10(energy / MEASURE_BLOCKS / (AMPLITUDE * AMPLITUDE / 2.0));
+}
+
+//¤=======================================================================================¤
+
+static void testStandardPoints() {
+    // IEC 61672-1 nominal A-weighting, the design is within 0.3 dB up to 2 kHz
+    CHECK_NEAR(weightedGain(31.5), -39.4, 0.5);
+    CHECK_NEAR(weightedGain(100.0), -19.1, 0.5);
+    CHECK_NEAR(weightedGain(1000.0), 0.0, 0.5);
+    CHECK_NEAR(weightedGain(2000.0), 1.2, 0.5);
+}
+
+static void testBiasRemoved() {
+    // A silent microphone is only its DC bias and must read as nothing
+    AWeightingFilter filter;
+    uint16_t block[BLOCK_SIZE];
+    for (int i = 0; i < BLOCK_SIZE; i++) {
+        block[i] = 8192;
+    }
+    CHECK_NEAR(filter.meanSquare(block, BLOCK_SIZE), 0.0, 1e-6);
+    CHECK(filter.meanSquare(block, 0) == 0.0f);
+}
+
+int main() {
+    testStandardPoints();
+    testBiasRemoved();
+    return TEST_RESULT();
+}
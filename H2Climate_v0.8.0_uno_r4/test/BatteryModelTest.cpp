@@ -0,0 +1,86 @@
+#include "TestAssert.h"
+#include "../src/utils/BatteryModel.h"
+
+static void testCurveEndpointsAndInterpolation() {
+    CHECK_NEAR(batteryStateOfCharge(9.6f, 25.0f), 100.0, 1e-6);
+    CHECK_NEAR(batteryStateOfCharge(6.5f, 25.0f), 0.0, 1e-6);
+    for (int i = 0; i < BATTERY_CURVE_POINTS; i++) {
+        CHECK_NEAR(batteryStateOfCharge(BATTERY_CURVE_VOLTAGE[i], 25.0f), BATTERY_CURVE_PERCENT[i], 1e-3);
+    }
+    // Halfway between two points is halfway between their charges
+    float voltage = (BATTERY_CURVE_VOLTAGE[3] + BATTERY_CURVE_VOLTAGE[4]) / 2;
+    CHECK_NEAR(batteryStateOfCharge(voltage, 25.0f), (BATTERY_CURVE_PERCENT[3] + BATTERY_CURVE_PERCENT[4]) / 2, 1e-3);
+}
+
+static void testCurveIsMonotonic() {
+    float previous = -1.0f;
+    for (int millivolts = 6500; millivolts <= 9600; millivolts += 10) {
+        float charge = batteryStateOfCharge(millivolts / 1000.0f, 25.0f);
+        CHECK(charge >= previous);
+        previous = charge;
+    }
+}
+
+static void testTemperatureCompensation() {
+    // A cold cell reads low, the same voltage at 0 °C means more charge left
+    float warm = batteryStateOfCharge(8.1f, 25.0f);
+    float cold = batteryStateOfCharge(8.1f, 0.0f);
+    CHECK(cold > warm);
+    CHECK_NEAR(batteryStateOfCharge(8.1f - 25.0f * BATTERY_TEMPERATURE_COEFFICIENT, 0.0f), warm, 1e-3);
+}
+
+static void testDrainTrendNeedsHistory() {
+    DrainTrend trend;
+    CHECK(trend.isPointDue(0));
+    for (int i = 0; i < BATTERY_TREND_MIN_POINTS - 1; i++) {
+        trend.add(90.0f - i, i * BATTERY_TREND_INTERVAL);
+        CHECK(isnan(trend.getRate()));
+    }
+    CHECK(!trend.isPointDue((BATTERY_TREND_MIN_POINTS - 2) * BATTERY_TREND_INTERVAL + 1));
+    CHECK(trend.isPointDue((BATTERY_TREND_MIN_POINTS - 1) * BATTERY_TREND_INTERVAL));
+}
+
+static void testSyntheticDischargeRamp() {
+    // Synthetic only, no discharge log of a real battery is available: a linear 0.3 V per hour
+    // ramp with ±20 mV of ADC noise, read through the curve. This checks the regression against
+    // the curve it is given, not the curve against a real cell
+    DrainTrend trend;
+    srand(3);
+    float lastCharge = 100.0f;
+    for (unsigned long t = 0; t <= 4UL * 3600000UL; t += BATTERY_TREND_INTERVAL) {
+        float volts = 9.2f - 0.3f * t / 3600000.0f + ((rand() % 41) - 20) / 1000.0f;
+        lastCharge = batteryStateOfCharge(volts, 25.0f);
+        trend.add(lastCharge, t);
+    }
+    // 8.7 V down to 8.1 V over the last two hours is 80 % to 50 % on the curve
+    CHECK_NEAR(trend.getRate(), 15.0, 1.5);
+    printf("drain rate %.2f %%/h, %.0f min left at %.0f %%\n", trend.getRate(), lastCharge / trend.getRate() * 60,
+           lastCharge);
+}
+
+static void testTrendFollowsRateChange() {
+    // Only the last BATTERY_TREND_POINTS count, a new load shows up within one history length
+    DrainTrend trend;
+    float charge = 100.0f;
+    unsigned long t = 0;
+    for (int i = 0; i < BATTERY_TREND_POINTS; i++, t += BATTERY_TREND_INTERVAL) {
+        trend.add(charge, t);
+        charge -= 5.0f * BATTERY_TREND_INTERVAL / 3600000.0f;
+    }
+    CHECK_NEAR(trend.getRate(), 5.0, 0.01);
+    for (int i = 0; i < BATTERY_TREND_POINTS; i++, t += BATTERY_TREND_INTERVAL) {
+        trend.add(charge, t);
+        charge -= 10.0f * BATTERY_TREND_INTERVAL / 3600000.0f;
+    }
+    CHECK_NEAR(trend.getRate(), 10.0, 0.01);
+}
+
+int main() {
+    testCurveEndpointsAndInterpolation();
+    testCurveIsMonotonic();
+    testTemperatureCompensation();
+    testDrainTrendNeedsHistory();
+    testSyntheticDischargeRamp();
+    testTrendFollowsRateChange();
+    return TEST_RESULT();
+}
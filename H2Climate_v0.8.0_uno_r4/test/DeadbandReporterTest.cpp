@@ -0,0 +1,186 @@
+#include "TestAssert.h"
+#include <vector>
+#include "../src/sensors/DeadbandReporter.h"
+#include "../src/sensors/DerivedChannels.h"
+#include "../src/sensors/TraceReplayDriver.h"
+#include "../src/sensors/traces/SyntheticOfficeTrace.h"
+
+const time_t START = 1767225600;
+const unsigned long WINDOW_SECONDS = 60;
+
+// One temperature window with the given statistics, ending `index` windows after START
+static WindowSummary window(int index, float mean, float low, float high) {
+    WindowSummary summary;
+    summary.startTimestamp = START + index * WINDOW_SECONDS;
+    summary.endTimestamp = summary.startTimestamp + WINDOW_SECONDS - 1;
+    summary.channelMask = 1 << CHANNEL_TEMPERATURE;
+    ChannelSummary& stats = summary.channels[CHANNEL_TEMPERATURE];
+    stats.count = 12;
+    stats.mean = mean;
+    stats.min = low;
+    stats.max = high;
+    stats.stddev = 0.0f;
+    return summary;
+}
+
+static unsigned long windowMillis(int index) {
+    return (index + 1) * WINDOW_SECONDS * 1000UL;
+}
+
+static void report(DeadbandReporter& reporter, int index, float mean) {
+    reporter.onReported(window(index, mean, mean, mean), windowMillis(index));
+}
+
+static void testMeanAndExtremes() {
+    float deadband = CHANNEL_DEADBAND[CHANNEL_TEMPERATURE];
+    DeadbandReporter reporter;
+    CHECK(reporter.evaluate(window(0, 21.0f, 21.0f, 21.0f), false, windowMillis(0)) == REPORT_CHANGED); // Nothing sent yet
+    report(reporter, 0, 21.0f);
+    report(reporter, 1, 21.0f);
+
+    // A flat window inside the band is suppressed
+    CHECK(reporter.evaluate(window(2, 21.0f, 21.0f - deadband / 2, 21.0f + deadband / 2), false, windowMillis(2)) == REPORT_SUPPRESSED);
+    CHECK(reporter.getSuppressedSinceReport() == 1);
+
+    // A short spike leaves the mean inside the band, the maximum gives it away
+    CHECK(reporter.evaluate(window(3, 21.0f + deadband / 2, 21.0f, 21.0f + 3 * deadband), false, windowMillis(3)) == REPORT_CHANGED);
+    CHECK(reporter.evaluate(window(3, 21.0f - deadband / 2, 21.0f - 3 * deadband, 21.0f), false, windowMillis(3)) == REPORT_CHANGED);
+    CHECK(reporter.evaluate(window(3, 21.0f + 2 * deadband, 21.0f + 2 * deadband, 21.0f + 2 * deadband), false, windowMillis(3)) == REPORT_CHANGED);
+}
+
+static void testLinearBand() {
+    DeadbandReporter reporter;
+    float deadband = CHANNEL_DEADBAND[CHANNEL_TEMPERATURE];
+    float slope = 0.5f; // Per window
+    report(reporter, 0, 20.0f);
+    report(reporter, 1, 20.0f + slope);
+
+    // A steady ramp follows the linear prediction, its extremes span the predicted line
+    if (REPORT_PREDICTOR == PREDICTOR_LINEAR) {
+        float end = 20.0f + 2 * slope;
+        CHECK(reporter.evaluate(window(2, end, end - slope, end), false, windowMillis(2)) == REPORT_SUPPRESSED);
+        CHECK(reporter.evaluate(window(2, end, end - slope - 2 * deadband, end), false, windowMillis(2)) == REPORT_CHANGED);
+    }
+}
+
+static void testHeartbeatAndForced() {
+    DeadbandReporter reporter;
+    report(reporter, 0, 21.0f);
+    report(reporter, 1, 21.0f);
+    unsigned long lastReport = windowMillis(1);
+    reporter.setHeartbeatInterval(5 * WINDOW_SECONDS * 1000UL);
+
+    // Forced windows go out, but count neither as suppressed nor against the ratio
+    CHECK(reporter.evaluate(window(2, 21.0f, 21.0f, 21.0f), true, windowMillis(2)) == REPORT_FORCED);
+    CHECK(reporter.getForcedCount() == 1);
+    CHECK(reporter.getSuppressedSinceReport() == 0);
+    CHECK(reporter.evaluate(window(3, 21.0f, 21.0f, 21.0f), false, windowMillis(3)) == REPORT_SUPPRESSED);
+    CHECK_NEAR(reporter.getSuppressionRatio(), 1.0 / 2.0, 1e-6); // One of the two evaluated since the initial reports
+
+    // The heartbeat is only seen when a window closes, up to one window after it is due
+    int index = 4;
+    while (reporter.evaluate(window(index, 21.0f, 21.0f, 21.0f), false, windowMillis(index)) == REPORT_SUPPRESSED) {
+        index++;
+    }
+    unsigned long silence = windowMillis(index) - lastReport;
+    CHECK(silence >= reporter.getHeartbeatInterval());
+    CHECK(silence <= reporter.getHeartbeatInterval() + WINDOW_SECONDS * 1000UL);
+}
+
+static void testChannelChange() {
+    DeadbandReporter reporter;
+    report(reporter, 0, 21.0f);
+    WindowSummary summary = window(1, 21.0f, 21.0f, 21.0f);
+    summary.channelMask |= 1 << CHANNEL_HUMIDITY;
+    summary.channels[CHANNEL_HUMIDITY] = summary.channels[CHANNEL_TEMPERATURE];
+    CHECK(reporter.evaluate(summary, false, windowMillis(1)) == REPORT_CHANGED);
+}
+
+static void testReconstructionError() {
+    // Replays the synthetic office trace through the aggregator and the reporter. A second reporter
+    // plays the server: it only sees the uploads and rebuilds every suppressed window with the same
+    // predictor. Each rebuilt mean, and every sample against the predicted line over the window,
+    // has to stay within the channel's deadband
+    std::vector<TraceReplayDriver::TraceRow> rows;
+    const char* position = SYNTHETIC_OFFICE_TRACE;
+    TraceReplayDriver::TraceRow row;
+    while (TraceReplayDriver::parseRow(position, row)) {
+        rows.push_back(row);
+    }
+    CHECK(rows.size() > 100);
+
+    hostSetMillis(0);
+    setTime(START);
+    WindowAggregator aggregator;
+    DeadbandReporter device;
+    DeadbandReporter server;
+    std::vector<SensorReading> windowSamples;
+    int suppressedWindows = 0;
+    double worstMeanError[SENSOR_CHANNEL_COUNT] = {};
+    double worstSampleError[SENSOR_CHANNEL_COUNT] = {};
+    size_t index = 0;
+    unsigned long endMillis = (rows.back().timestamp + 1) * 1000UL;
+
+    for (unsigned long t = 0; t < endMillis; t += LOOP_INTERVAL) {
+        hostSetMillis(t);
+        while (index + 1 < rows.size() && rows[index + 1].timestamp * 1000UL <= t) {
+            index++;
+        }
+
+        if (aggregator.isWindowDue(millis())) {
+            WindowSummary summary;
+            aggregator.takeSummary(summary);
+            if (device.evaluate(summary, false, millis()) == REPORT_SUPPRESSED) {
+                suppressedWindows++;
+                for (int channel = 0; channel < SENSOR_CHANNEL_COUNT; channel++) {
+                    if (!(summary.channelMask & (1 << channel))) {
+                        continue;
+                    }
+                    float predictedStart = server.predict((SensorChannel)channel, summary.startTimestamp);
+                    float predictedEnd = server.predict((SensorChannel)channel, summary.endTimestamp);
+                    double meanError = fabs(summary.channels[channel].mean - predictedEnd);
+                    worstMeanError[channel] = fmax(worstMeanError[channel], meanError / CHANNEL_DEADBAND[channel]);
+                    CHECK(meanError <= CHANNEL_DEADBAND[channel] + 1e-4);
+                    for (const SensorReading& sample : windowSamples) {
+                        // Distance outside the band the predicted line sweeps over the window
+                        float value = sample.values[channel];
+                        double below = fmin(predictedStart, predictedEnd) - value;
+                        double above = value - fmax(predictedStart, predictedEnd);
+                        double sampleError = fmax(fmax(below, above), 0.0);
+                        worstSampleError[channel] = fmax(worstSampleError[channel], sampleError / CHANNEL_DEADBAND[channel]);
+                        CHECK(sampleError <= CHANNEL_DEADBAND[channel] + 1e-4);
+                    }
+                }
+            } else {
+                device.onReported(summary, millis());
+                server.onReported(summary, millis());
+            }
+            windowSamples.clear();
+        }
+
+        SensorReading reading{};
+        reading.set(CHANNEL_TEMPERATURE, rows[index].temperature);
+        reading.set(CHANNEL_HUMIDITY, rows[index].humidity);
+        addDerivedChannels(reading);
+        aggregator.add(reading, now(), millis());
+        windowSamples.push_back(reading);
+    }
+
+    // The check is empty unless the deadband actually held windows back
+    printf("suppressed %d windows\n", suppressedWindows);
+    for (int channel = 0; channel < SENSOR_CHANNEL_COUNT; channel++) {
+        if (worstMeanError[channel] > 0.0 || worstSampleError[channel] > 0.0) {
+            printf("channel %d worst error: mean %.2f, sample %.2f deadbands\n", channel, worstMeanError[channel], worstSampleError[channel]);
+        }
+    }
+    CHECK(suppressedWindows > 10);
+}
+
+int main() {
+    testMeanAndExtremes();
+    testLinearBand();
+    testHeartbeatAndForced();
+    testChannelChange();
+    testReconstructionError();
+    return TEST_RESULT();
+}
@@ -0,0 +1,131 @@
+#include "TestAssert.h"
+#include <chrono>
+#include "../src/sensors/DerivedChannels.h"
+
+// Magnus in double precision, the formula the lookup table was generated from
+static double magnusPressure(double temperature) {
+    return 6.112 * exp(17.62 * temperature / (243.12 + temperature));
+}
+
+static double magnusDewPoint(double temperature, double humidity) {
+    double gamma = log(magnusPressure(temperature) * humidity / 100.0 / 6.112);
+    return 243.12 * gamma / (17.62 - gamma);
+}
+
+//¤=======================================================================================¤
+
+static void testDewPointSweep() {
+    double worst = 0.0;
+    for (int t = -400; t <= 800; t += 5) {
+        for (int rh = 1; rh <= 100; rh++) {
+            double temperature = t / 10.0;
+            double error = fabs(dewPoint(temperature, rh) - magnusDewPoint(temperature, rh));
+            worst = error > worst ? error : worst;
+        }
+    }
+    printf("dew point worst error %.4f °C\n", worst);
+    CHECK(worst < 0.05);
+}
+
+static void testColdDryDewPointBelowTable() {
+    // Saturates below the -40 °C end of the table, used to clamp there
+    CHECK_NEAR(dewPoint(-20.0f, 10.0f), magnusDewPoint(-20.0, 10.0), 0.05);
+    CHECK_NEAR(dewPoint(-35.0f, 5.0f), magnusDewPoint(-35.0, 5.0), 0.05);
+    CHECK(dewPoint(-20.0f, 10.0f) < -40.0f);
+    CHECK(isnan(dewPoint(20.0f, 0.0f)));
+    CHECK_NEAR(dewPoint(25.0f, 100.0f), 25.0, 1e-6);
+}
+
+static void testAbsoluteHumiditySweep() {
+    double worst = 0.0;
+    for (int t = -400; t <= 800; t += 5) {
+        for (int rh = 5; rh <= 100; rh += 5) {
+            double temperature = t / 10.0;
+            double exact = 216.68 * magnusPressure(temperature) * rh / 100.0 / (temperature + 273.15);
+            double error = fabs(absoluteHumidity(temperature, rh) - exact) / exact;
+            worst = error > worst ? error : worst;
+        }
+    }
+    printf("absolute humidity worst relative error %.4f %%\n", 100.0 * worst);
+    CHECK(worst < 0.002); // Linear interpolation between 1 °C table entries
+}
+
+static void testHeatIndexAgainstNoaaTable() {
+    // NOAA heat index chart, °F: 90 °F at 70 % is 106 °F, 100 °F at 40 % is 109 °F
+    CHECK_NEAR(heatIndex((90.0f - 32.0f) / 1.8f, 70.0f) * 1.8f + 32.0f, 106.0, 1.0);
+    CHECK_NEAR(heatIndex((100.0f - 32.0f) / 1.8f, 40.0f) * 1.8f + 32.0f, 109.0, 1.0);
+    // Below 80 °F the simple formula keeps it close to the air temperature
+    CHECK_NEAR(heatIndex(20.0f, 50.0f), 20.0, 1.0);
+}
+
+static void testThermalComfort() {
+    float previousPmv = -10.0f;
+    for (int t = 10; t <= 35; t++) {
+        float pmv, ppd;
+        int iterations = 0;
+        CHECK(thermalComfort(t, 50.0f, pmv, ppd, &iterations));
+        CHECK(iterations <= COMFORT_MAX_ITERATIONS);
+        CHECK(pmv > previousPmv); // Warmer always feels warmer
+        CHECK(ppd >= 5.0f - 1e-3f && ppd <= 100.0f);
+        previousPmv = pmv;
+    }
+
+    // An office at 1.2 met and 0.7 clo is neutral in the low twenties
+    float pmv, ppd;
+    thermalComfort(23.0f, 50.0f, pmv, ppd);
+    CHECK(fabs(pmv) < 0.5f);
+    CHECK(ppd < 10.0f);
+}
+
+static void testThermalComfortTiming() {
+    // Wall-clock cost on the build host, printed for comparison between changes, not asserted.
+    // The sweep covers 15-35 °C and 20-90 %RH, the range an office sensor reports
+    const int ROUNDS = 100;
+    long evaluations = 0, totalIterations = 0;
+    int worstIterations = 0;
+    float sink = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (int t = 150; t <= 350; t += 5) {
+            for (int rh = 20; rh <= 90; rh += 3) {
+                float pmv, ppd;
+                int iterations = 0;
+                if (thermalComfort(t / 10.0f, rh, pmv, ppd, &iterations)) {
+                    sink += pmv;
+                }
+                evaluations++;
+                totalIterations += iterations;
+                worstIterations = iterations > worstIterations ? iterations : worstIterations;
+            }
+        }
+    }
+    double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    printf("PMV %ld evaluations, %.3f us each, iterations mean %.1f worst %d (sum %.1f)\n", evaluations,
+           elapsed / evaluations, (double)totalIterations / evaluations, worstIterations, sink);
+    CHECK(worstIterations <= COMFORT_MAX_ITERATIONS);
+}
+
+static void testAddDerivedChannels() {
+    SensorReading reading;
+    reading.channelMask = 0;
+    reading.status = SENSOR_OK;
+    addDerivedChannels(reading);
+    CHECK(reading.channelMask == 0); // Nothing to derive from
+
+    reading.set(CHANNEL_TEMPERATURE, 22.0f);
+    reading.set(CHANNEL_HUMIDITY, 0.0f);
+    addDerivedChannels(reading);
+    CHECK(!reading.has(CHANNEL_DEW_POINT)); // No dew point in perfectly dry air
+    CHECK(reading.has(CHANNEL_ABSOLUTE_HUMIDITY) == ENABLE_ABSOLUTE_HUMIDITY);
+}
+
+int main() {
+    testDewPointSweep();
+    testColdDryDewPointBelowTable();
+    testAbsoluteHumiditySweep();
+    testHeatIndexAgainstNoaaTable();
+    testThermalComfort();
+    testThermalComfortTiming();
+    testAddDerivedChannels();
+    return TEST_RESULT();
+}
@@ -0,0 +1,110 @@
+#include "TestAssert.h"
+#include "EnergyModel.h"
+#include "../src/utils/DutyCyclePolicy.h"
+
+static void testChargeSelectsPolicy() {
+    DutyCyclePolicy policy;
+    CHECK(policy.getIndex() == 0);
+    CHECK(!policy.update(100, -60));
+    for (int i = 1; i < DUTY_POLICY_COUNT; i++) {
+        CHECK(policy.update(DUTY_POLICY_MIN_PERCENT[i - 1] - 1, -60));
+        CHECK(policy.getIndex() == i);
+    }
+    CHECK(!policy.update(0, -60));
+    CHECK(policy.getIndex() == DUTY_POLICY_COUNT - 1);
+}
+
+static void testHysteresis() {
+    DutyCyclePolicy policy;
+    policy.update(DUTY_POLICY_MIN_PERCENT[0] - 1, -60);
+    CHECK(policy.getIndex() == 1);
+    // Back at the threshold is not enough, it takes the margin on top
+    CHECK(!policy.update(DUTY_POLICY_MIN_PERCENT[0], -60));
+    CHECK(!policy.update(DUTY_POLICY_MIN_PERCENT[0] + DUTY_POLICY_HYSTERESIS - 1, -60));
+    CHECK(policy.update(DUTY_POLICY_MIN_PERCENT[0] + DUTY_POLICY_HYSTERESIS, -60));
+    CHECK(policy.getIndex() == 0);
+}
+
+static void testWeakLink() {
+    DutyCyclePolicy policy;
+    CHECK(policy.update(100, DUTY_WEAK_LINK_RSSI - 5));
+    CHECK(policy.getIndex() == 1);
+    CHECK(policy.isWeakLink());
+    // Unknown RSSI while the radio is parked keeps the last reading
+    CHECK(!policy.update(100, 0));
+    CHECK(policy.isWeakLink());
+    // Recovery needs the link hysteresis as well
+    CHECK(!policy.update(100, DUTY_WEAK_LINK_RSSI + 1));
+    CHECK(policy.update(100, DUTY_WEAK_LINK_RSSI + DUTY_LINK_HYSTERESIS));
+    CHECK(policy.getIndex() == 0);
+    // The leanest policy has nowhere further to go
+    policy.update(0, -60);
+    CHECK(!policy.update(0, DUTY_WEAK_LINK_RSSI - 10));
+}
+
+static void testChangeAnnouncement() {
+    DutyCyclePolicy policy;
+    StaticJsonDocument<512> quiet;
+    CHECK(!policy.attachChange(quiet));
+
+    policy.update(DUTY_POLICY_MIN_PERCENT[0] - 1, -60);
+    CHECK(policy.isChangePending());
+    StaticJsonDocument<512> jsonDoc;
+    CHECK(policy.attachChange(jsonDoc));
+    String payload;
+    serializeJson(jsonDoc, payload);
+    CHECK(payload.indexOf("\"name\":\"balanced\"") >= 0);
+    CHECK(payload.indexOf("\"previous\":\"full\"") >= 0);
+    CHECK(payload.indexOf("\"reason\":\"battery\"") >= 0);
+    // Worst-case silence is the heartbeat plus the window it waits for
+    unsigned long silence = (DUTY_POLICY_UPLOAD_INTERVAL[1] + DUTY_POLICY_SAMPLING_INTERVAL[1] * DUTY_POLICY_BATCH_SIZE[1]) / 1000;
+    CHECK(payload.indexOf("\"maxSilenceSeconds\":" + String(silence)) >= 0);
+
+    policy.clearChange();
+    CHECK(!policy.isChangePending());
+}
+
+//¤=======================================================================================¤
+
+// Worst case for the deadband: every window is uploaded
+static double averageCurrent(int index) {
+    unsigned long sampling = DUTY_POLICY_SAMPLING_INTERVAL[index];
+    unsigned long window = sampling * DUTY_POLICY_BATCH_SIZE[index];
+    return modelFloorCurrent(window) + MODEL_SAMPLE_CHARGE * 1000.0 / sampling + modelUploadCharge(window) * 1000.0 / window;
+}
+
+static void testProjectedLifetime() {
+    double previousHours = 0.0;
+    for (int i = 0; i < DUTY_POLICY_COUNT; i++) {
+        double hours = MODEL_CAPACITY_MAS / averageCurrent(i) / 3600.0;
+        printf("%-9s %5.1f mA  %5.1f h\n", DUTY_POLICY_NAME[i], averageCurrent(i), hours);
+        CHECK(hours > previousHours); // Every leaner policy has to pay off
+        previousHours = hours;
+    }
+
+    // Let the policy pick as the battery drains, one step per minute
+    DutyCyclePolicy policy;
+    double charge = MODEL_CAPACITY_MAS, seconds = 0.0;
+    int changes = 0;
+    while (charge > 0.0) {
+        int percent = (int)(100.0 * charge / MODEL_CAPACITY_MAS);
+        changes += policy.update(percent, -60) ? 1 : 0;
+        charge -= averageCurrent(policy.getIndex()) * 60.0;
+        seconds += 60.0;
+    }
+    double adaptiveHours = seconds / 3600.0;
+    double fullHours = MODEL_CAPACITY_MAS / averageCurrent(0) / 3600.0;
+    printf("adaptive  %5.1f h, %d changes\n", adaptiveHours, changes);
+    CHECK(changes == DUTY_POLICY_COUNT - 1); // No flapping on a steady drain
+    CHECK(adaptiveHours > fullHours * 1.1);
+    CHECK(adaptiveHours < previousHours);
+}
+
+int main() {
+    testChargeSelectsPolicy();
+    testHysteresis();
+    testWeakLink();
+    testChangeAnnouncement();
+    testProjectedLifetime();
+    return TEST_RESULT();
+}
@@ -0,0 +1,30 @@
+#ifndef ENERGY_MODEL_H
+#define ENERGY_MODEL_H
+
+// Per-operation energy model for the host simulations, built on the PowerManager
+// currents in Config.h. Charges are in mA*s on top of the always-on floor.
+
+#include "../src/config/Config.h"
+
+const double MODEL_CAPACITY_MAS = 550.0 * 3600.0; // 9 V alkaline
+const double MODEL_SAMPLE_CHARGE = 0.5; // Sensor frame, filter and loop work
+const double MODEL_UPLOAD_CHARGE = 100.0; // HTTP POST incl. retries on average
+const double MODEL_ASSOCIATE_CHARGE = 120.0; // Waking a parked radio, ~3 s at +40 mA
+
+// The radio is parked between uploads when the window leaves a long enough gap
+inline bool modelParksRadio(unsigned long windowMillis) {
+    return ENABLE_RADIO_PARKING && windowMillis > POWER_RADIO_PARK_MIN_GAP;
+}
+
+// Average floor current in mA, the MCU sleeps and the radio is up or parked
+inline double modelFloorCurrent(unsigned long windowMillis) {
+    double radioUp = modelParksRadio(windowMillis) ? (POWER_RADIO_WAKE_LEAD + 5000.0) / windowMillis : 1.0;
+    double radio = radioUp * POWER_RADIO_SLEEP_CURRENT + (1.0 - radioUp) * POWER_RADIO_OFF_CURRENT;
+    return POWER_BOARD_CURRENT + POWER_MCU_SLEEP_CURRENT + radio;
+}
+
+inline double modelUploadCharge(unsigned long windowMillis) {
+    return MODEL_UPLOAD_CHARGE + (modelParksRadio(windowMillis) ? MODEL_ASSOCIATE_CHARGE : 0.0);
+}
+
+#endif // ENERGY_MODEL_H
@@ -0,0 +1,191 @@
+// Replays a trace through the firmware pipeline on the virtual clock.
+//   HostReplay [trace.csv] [--passes N] [--rssi dBm]
+// Without a path the synthetic office trace is used, no recorded trace ships with
+// the repository, so the numbers it prints describe generated data only. The trace format is the one
+// the TraceReplayDriver reads: "timestamp,temperature,humidity,battery" rows with
+// seconds, °C, %, battery pin voltage. Every component gets the virtual millis()
+// and now(), so windows, heartbeats, alert durations, the drain trend and the duty
+// policy run at trace speed, a day of trace takes milliseconds.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+#include "EnergyModel.h"
+#include "../src/sensors/ReadingFilter.h"
+#include "../src/sensors/DerivedChannels.h"
+#include "../src/sensors/OccupancyDetector.h"
+#include "../src/sensors/AlertEngine.h"
+#include "../src/sensors/WindowAggregator.h"
+#include "../src/sensors/DeadbandReporter.h"
+#include "../src/sensors/TraceReplayDriver.h"
+#include "../src/sensors/traces/SyntheticOfficeTrace.h"
+#include "../src/utils/BatteryModel.h"
+#include "../src/utils/DutyCyclePolicy.h"
+
+const time_t REPLAY_EPOCH = 1767225600; // 2026-01-01, for traces that start at zero
+const unsigned long UNIX_TIMESTAMP_MIN = 1000000000UL;
+
+static bool loadTrace(const char* path, std::string& text) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    char chunk[4096];
+    size_t length;
+    while ((length = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        text.append(chunk, length);
+    }
+    fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    int passes = 1;
+    long rssi = -60;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--passes" && i + 1 < argc) {
+            passes = atoi(argv[++i]);
+        } else if (arg == "--rssi" && i + 1 < argc) {
+            rssi = atol(argv[++i]);
+        } else {
+            path = argv[i];
+        }
+    }
+
+    std::string text;
+    if (path == nullptr) {
+        text = SYNTHETIC_OFFICE_TRACE;
+    } else if (!loadTrace(path, text)) {
+        fprintf(stderr, "Cannot read %s\n", path);
+        return 1;
+    }
+
+    std::vector<TraceReplayDriver::TraceRow> rows;
+    const char* position = text.c_str();
+    TraceReplayDriver::TraceRow row;
+    while (TraceReplayDriver::parseRow(position, row)) {
+        rows.push_back(row);
+    }
+    if (rows.empty()) {
+        fprintf(stderr, "No rows in %s\n", path != nullptr ? path : "the synthetic trace");
+        return 1;
+    }
+    unsigned long firstTimestamp = rows.front().timestamp;
+    unsigned long passSeconds = rows.back().timestamp - firstTimestamp + 1;
+    unsigned long endMillis = passSeconds * 1000UL * passes;
+
+    hostSetMillis(0);
+    setTime(firstTimestamp >= UNIX_TIMESTAMP_MIN ? (time_t)firstTimestamp : REPLAY_EPOCH);
+
+    ReadingFilter filter;
+    OccupancyDetector occupancy;
+    AlertEngine alerts;
+    WindowAggregator aggregator;
+    DeadbandReporter reporter;
+    DrainTrend trend;
+    DutyCyclePolicy policy;
+
+    unsigned long samples = 0, windows = 0, uploads = 0, heartbeats = 0, forced = 0, suppressed = 0;
+    unsigned long alertChanges = 0, policyChanges = 0, occupiedSamples = 0;
+    double charge = 0.0; // mA*s above nothing, from the energy model
+    unsigned long lastMillis = 0;
+    size_t index = 0;
+    int batteryPercentage = 100;
+
+    // Same order as the sketch loop: policy at the start of a cycle, then the sample
+    for (unsigned long t = 0; t < endMillis;) {
+        hostSetMillis(t);
+        charge += modelFloorCurrent(policy.getWindowLength()) * (t - lastMillis) / 1000.0;
+        lastMillis = t;
+
+        if (policy.update(batteryPercentage, rssi)) {
+            aggregator.setWindowLength(policy.getWindowLength());
+            reporter.setHeartbeatInterval(policy.getUploadInterval());
+            policyChanges++;
+            printf("%8.2f h  policy %s\n", t / 3600000.0, policy.getName());
+        }
+
+        // Latest row at or before the virtual time, wrapping between passes
+        unsigned long traceSeconds = (t / 1000) % passSeconds;
+        if (traceSeconds == 0 || rows[index].timestamp - firstTimestamp > traceSeconds) {
+            index = 0;
+        }
+        while (index + 1 < rows.size() && rows[index + 1].timestamp - firstTimestamp <= traceSeconds) {
+            index++;
+        }
+        const TraceReplayDriver::TraceRow& current = rows[index];
+
+        SensorReading reading{};
+        reading.set(CHANNEL_TEMPERATURE, current.temperature);
+        reading.set(CHANNEL_HUMIDITY, current.humidity);
+        filter.apply(reading);
+        addDerivedChannels(reading);
+        occupancy.update(reading, millis());
+        samples++;
+        charge += MODEL_SAMPLE_CHARGE;
+        if (occupancy.getLikelihood() >= 50) {
+            occupiedSamples++;
+        }
+
+        // Later passes repeat the climate only, a battery that recovers would break the trend
+        if (!isnan(current.battery) && t / 1000 < passSeconds) {
+            float stateOfCharge = batteryStateOfCharge(current.battery * VOLTAGE_TO_BATTERY, reading.values[CHANNEL_TEMPERATURE]);
+            if (trend.isPointDue(millis())) {
+                trend.add(stateOfCharge, millis());
+            }
+            batteryPercentage = (int)stateOfCharge;
+        }
+
+        uint16_t changed = alerts.evaluate(reading, millis());
+        for (int i = 0; i < MAX_ALERT_RULES; i++) {
+            if (changed & (1 << i)) {
+                alertChanges++;
+                printf("%8.2f h  alert %d %s\n", t / 3600000.0, i, alerts.isActive(i) ? "raised" : "cleared");
+            }
+        }
+
+        if (aggregator.isWindowDue(millis())) {
+            WindowSummary summary;
+            aggregator.takeSummary(summary);
+            windows++;
+            ReportReason reason = reporter.evaluate(summary, policy.isChangePending(), millis());
+            if (reason == REPORT_SUPPRESSED) {
+                suppressed++;
+            } else {
+                // Uploads always succeed here, the link quality only steers the policy
+                if (reason == REPORT_HEARTBEAT) {
+                    heartbeats++;
+                } else if (reason == REPORT_FORCED) {
+                    forced++;
+                }
+                uploads++;
+                charge += modelUploadCharge(policy.getWindowLength());
+                reporter.onReported(summary, millis());
+                policy.clearChange();
+            }
+        }
+        aggregator.add(reading, now(), millis());
+
+        unsigned long samplingInterval = policy.getSamplingInterval();
+        if (occupancy.isChangeDetected() && policy.allowsFastSampling()) {
+            samplingInterval = OCCUPANCY_FAST_INTERVAL;
+        }
+        t += samplingInterval;
+    }
+
+    double hours = endMillis / 3600000.0;
+    double averageCurrent = charge / (endMillis / 1000.0);
+    printf("Replayed %.1f h of trace in %d pass(es), %u rows\n", hours, passes, (unsigned)rows.size());
+    printf("Samples %lu | occupied %lu | windows %lu | uploads %lu (heartbeat %lu, policy %lu) | suppressed %lu\n",
+           samples, occupiedSamples, windows, uploads, heartbeats, forced, suppressed);
+    printf("Alert changes %lu | policy changes %lu | drain %.2f %%/h\n", alertChanges, policyChanges, trend.getRate());
+    printf("Energy %.1f mAh | avg %.2f mA | projected %.1f h on %.0f mAh\n", charge / 3600.0, averageCurrent,
+           MODEL_CAPACITY_MAS / averageCurrent / 3600.0, MODEL_CAPACITY_MAS / 3600.0);
+
+    // Smoke checks for ctest: the pipeline ran and the clock reached every window
+    bool ok = samples > 0 && windows >= endMillis / policy.getWindowLength() / 2 && uploads > 0;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+#include "TestAssert.h"
+#include "../src/sensors/OccupancyDetector.h"
+#include "../src/sensors/TraceReplayDriver.h"
+#include "../src/sensors/traces/SyntheticOfficeTrace.h"
+
+const unsigned long SAMPLE_MILLIS = 10000;
+
+static SensorReading feed(OccupancyDetector& detector, float temperature, float humidity, unsigned long currentMillis) {
+    SensorReading reading;
+    reading.channelMask = 0;
+    reading.status = SENSOR_OK;
+    reading.set(CHANNEL_TEMPERATURE, temperature);
+    reading.set(CHANNEL_HUMIDITY, humidity);
+    detector.update(reading, currentMillis);
+    return reading;
+}
+
+//¤=======================================================================================¤
+
+static void testEmptyRoomStaysEmpty() {
+    OccupancyDetector detector;
+    SensorReading reading;
+    for (int i = 0; i < 60; i++) {
+        reading = feed(detector, 21.0f + (i % 2) * 0.05f, 40.0f + (i % 3) * 0.1f, i * SAMPLE_MILLIS);
+        // The channel only appears once the window is full
+        CHECK(reading.has(CHANNEL_OCCUPANCY) == (i >= OCCUPANCY_WINDOW - 1));
+    }
+    CHECK(detector.getLikelihood() < 20);
+    CHECK(!detector.isChangeDetected());
+}
+
+static void testPeopleRaiseLikelihood() {
+    OccupancyDetector detector;
+    for (int i = 0; i < 30; i++) {
+        feed(detector, 21.0f, 40.0f, i * SAMPLE_MILLIS);
+    }
+    // Breathing and body heat: humidity and temperature climb together
+    for (int i = 0; i < 30; i++) {
+        float minutes = i * SAMPLE_MILLIS / 60000.0f;
+        feed(detector, 21.0f + 0.12f * minutes, 40.0f + 0.6f * minutes, (30 + i) * SAMPLE_MILLIS);
+    }
+    CHECK(detector.getLikelihood() >= 75);
+    CHECK(detector.isChangeDetected());
+
+    // After the room empties the likelihood falls gradually, not in one step
+    int previous = detector.getLikelihood();
+    unsigned long start = 60 * SAMPLE_MILLIS;
+    for (int i = 0; i < 60; i++) {
+        feed(detector, 24.0f, 46.0f, start + i * SAMPLE_MILLIS);
+        CHECK(detector.getLikelihood() >= previous - OCCUPANCY_DECAY);
+        previous = detector.getLikelihood();
+    }
+    CHECK(detector.getLikelihood() == 0);
+    CHECK(!detector.isChangeDetected());
+}
+
+static void testFallingHumidityIsChangeOnly() {
+    OccupancyDetector detector;
+    for (int i = 0; i < 30; i++) {
+        float minutes = i * SAMPLE_MILLIS / 60000.0f;
+        feed(detector, 21.0f, 50.0f - 0.8f * minutes, i * SAMPLE_MILLIS); // A window was opened
+    }
+    CHECK(detector.isChangeDetected());
+    CHECK(detector.getLikelihood() < 30);
+}
+
+static void testSyntheticOfficeTrace() {
+    // One row per trace minute, replayed on the virtual clock
+    hostSetMillis(0);
+    TraceReplayDriver trace(SYNTHETIC_OFFICE_TRACE);
+    CHECK(trace.begin());
+    OccupancyDetector detector;
+    int emptyPeak = 0, arrivalPeak = 0, arrivalMinute = -1;
+    for (int minute = 0; minute < 120; minute++) {
+        hostSetMillis(minute * 60000UL / TRACE_REPLAY_SPEEDUP);
+        SensorReading reading;
+        reading.channelMask = 0;
+        reading.status = SENSOR_OK;
+        CHECK(trace.read(reading));
+        detector.update(reading, minute * 60000UL);
+
+        // People arrive at minute 30. The detector sees dynamics, so a room that has
+        // settled while occupied decays again, only the arrival has to stand out
+        int likelihood = detector.getLikelihood();
+        if (minute < 30) {
+            emptyPeak = max(emptyPeak, likelihood);
+        } else if (minute < 60) {
+            arrivalPeak = max(arrivalPeak, likelihood);
+            if (arrivalMinute < 0 && likelihood >= OCCUPANCY_CHANGE_LIKELIHOOD) {
+                arrivalMinute = minute;
+            }
+        }
+    }
+    printf("trace likelihood: empty peak %d %%, arrival peak %d %%, detected after %d min\n", emptyPeak, arrivalPeak,
+           arrivalMinute - 30);
+    CHECK(emptyPeak < 10);
+    CHECK(arrivalPeak > 50);
+    CHECK(arrivalMinute >= 30 && arrivalMinute <= 40);
+}
+
+int main() {
+    testEmptyRoomStaysEmpty();
+    testPeopleRaiseLikelihood();
+    testFallingHumidityIsChangeOnly();
+    testSyntheticOfficeTrace();
+    return TEST_RESULT();
+}
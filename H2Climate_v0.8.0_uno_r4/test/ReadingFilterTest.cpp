@@ -0,0 +1,196 @@
+#include "TestAssert.h"
+#include "../src/sensors/ReadingFilter.h"
+#include "../src/sensors/TraceReplayDriver.h"
+#include "../src/sensors/traces/SyntheticOfficeTrace.h"
+
+static SensorReading makeReading(SensorChannel channel, float value) {
+    SensorReading reading;
+    reading.channelMask = 0;
+    reading.status = SENSOR_OK;
+    reading.set(channel, value);
+    return reading;
+}
+
+static SensorReading feed(ReadingFilter& filter, SensorChannel channel, float value) {
+    SensorReading reading = makeReading(channel, value);
+    filter.apply(reading);
+    return reading;
+}
+
+//¤=======================================================================================¤
+
+static void testConstantPassesThrough() {
+    ReadingFilter filter;
+    SensorReading reading;
+    for (int i = 0; i < 20; i++) {
+        reading = feed(filter, CHANNEL_TEMPERATURE, 21.37f);
+    }
+    CHECK(reading.has(CHANNEL_TEMPERATURE));
+    CHECK_NEAR(reading.values[CHANNEL_TEMPERATURE], 21.37, 1.0 / 256);
+}
+
+static void testOutOfRangeIsRejected() {
+    ReadingFilter filter;
+    SensorReading reading = feed(filter, CHANNEL_TEMPERATURE, 100.0f);
+    CHECK(!reading.has(CHANNEL_TEMPERATURE));
+    CHECK(reading.status == SENSOR_READ_FAILED);
+    CHECK(filter.getRejectedCount(CHANNEL_TEMPERATURE) == 1);
+
+    // Impossible values stay rejected no matter how often they repeat
+    for (int i = 0; i < 10; i++) {
+        reading = feed(filter, CHANNEL_TEMPERATURE, -60.0f);
+        CHECK(!reading.has(CHANNEL_TEMPERATURE));
+    }
+    CHECK(filter.getRejectedCount(CHANNEL_TEMPERATURE) == 11);
+}
+
+static void testSingleOutlierIsDropped() {
+    ReadingFilter filter;
+    for (int i = 0; i < 10; i++) {
+        feed(filter, CHANNEL_TEMPERATURE, 21.0f);
+    }
+    SensorReading spike = feed(filter, CHANNEL_TEMPERATURE, 30.0f); // Beyond CHANNEL_MAX_STEP
+    CHECK(!spike.has(CHANNEL_TEMPERATURE));
+    CHECK(filter.getRejectedCount(CHANNEL_TEMPERATURE) == 1);
+
+    SensorReading next = feed(filter, CHANNEL_TEMPERATURE, 21.1f);
+    CHECK(next.has(CHANNEL_TEMPERATURE));
+    CHECK_NEAR(next.values[CHANNEL_TEMPERATURE], 21.0, 0.1);
+}
+
+static void testPersistentJumpIsAccepted() {
+    ReadingFilter filter;
+    for (int i = 0; i < 10; i++) {
+        feed(filter, CHANNEL_TEMPERATURE, 21.0f);
+    }
+    // The sensor moved to a warmer spot, the level is real once it repeats
+    SensorReading reading;
+    for (int i = 1; i < FILTER_MAX_CONSECUTIVE_REJECTS; i++) {
+        reading = feed(filter, CHANNEL_TEMPERATURE, 27.0f);
+        CHECK(!reading.has(CHANNEL_TEMPERATURE));
+    }
+    reading = feed(filter, CHANNEL_TEMPERATURE, 27.0f);
+    CHECK(reading.has(CHANNEL_TEMPERATURE));
+    CHECK_NEAR(reading.values[CHANNEL_TEMPERATURE], 27.0, 1.0 / 256);
+}
+
+static void testOutOfRangeDoesNotCountTowardsJump() {
+    ReadingFilter filter;
+    for (int i = 0; i < 10; i++) {
+        feed(filter, CHANNEL_TEMPERATURE, 21.0f);
+    }
+    // Glitches between the jump samples must not make up the repeats of a new level
+    SensorReading reading;
+    for (int i = 1; i < FILTER_MAX_CONSECUTIVE_REJECTS; i++) {
+        reading = feed(filter, CHANNEL_TEMPERATURE, 150.0f);
+        CHECK(!reading.has(CHANNEL_TEMPERATURE));
+    }
+    reading = feed(filter, CHANNEL_TEMPERATURE, 27.0f);
+    CHECK(!reading.has(CHANNEL_TEMPERATURE));
+    CHECK(filter.getRejectedCount(CHANNEL_TEMPERATURE) == FILTER_MAX_CONSECUTIVE_REJECTS);
+
+    // Only in-range repeats of the jump count
+    for (int i = 2; i < FILTER_MAX_CONSECUTIVE_REJECTS; i++) {
+        reading = feed(filter, CHANNEL_TEMPERATURE, 27.0f);
+        CHECK(!reading.has(CHANNEL_TEMPERATURE));
+    }
+    reading = feed(filter, CHANNEL_TEMPERATURE, 27.0f);
+    CHECK(reading.has(CHANNEL_TEMPERATURE));
+    CHECK_NEAR(reading.values[CHANNEL_TEMPERATURE], 27.0, 1.0 / 256);
+}
+
+static void testStepResponseSettles() {
+    ReadingFilter filter;
+    for (int i = 0; i < 10; i++) {
+        feed(filter, CHANNEL_TEMPERATURE, 20.0f);
+    }
+    // A believable step is followed, smoothed but without a lasting offset
+    SensorReading first = feed(filter, CHANNEL_TEMPERATURE, 22.0f);
+    CHECK(first.values[CHANNEL_TEMPERATURE] < 21.0f);
+    SensorReading reading;
+    for (int i = 0; i < 40; i++) {
+        reading = feed(filter, CHANNEL_TEMPERATURE, 22.0f);
+    }
+    CHECK_NEAR(reading.values[CHANNEL_TEMPERATURE], 22.0, 0.05);
+}
+
+static void testMedianRemovesSpike() {
+    ReadingFilter filter;
+    for (int i = 0; i < 10; i++) {
+        feed(filter, CHANNEL_HUMIDITY, 40.0f);
+    }
+    // Within the step limit, so only the median stage can take it out
+    SensorReading spike = feed(filter, CHANNEL_HUMIDITY, 50.0f);
+    CHECK(spike.has(CHANNEL_HUMIDITY));
+    CHECK_NEAR(spike.values[CHANNEL_HUMIDITY], 40.0, 0.1);
+    SensorReading after = feed(filter, CHANNEL_HUMIDITY, 40.0f);
+    CHECK_NEAR(after.values[CHANNEL_HUMIDITY], 40.0, 0.1);
+}
+
+static void testNoiseIsReduced() {
+    ReadingFilter filter;
+    double inputSquares = 0.0, outputSquares = 0.0;
+    srand(1);
+    for (int i = 0; i < 500; i++) {
+        float noise = ((rand() % 2001) - 1000) / 1000.0f * 0.3f;
+        SensorReading reading = feed(filter, CHANNEL_TEMPERATURE, 21.0f + noise);
+        if (i >= 50) {
+            double error = reading.values[CHANNEL_TEMPERATURE] - 21.0;
+            inputSquares += noise * noise;
+            outputSquares += error * error;
+        }
+    }
+    // Median and Kalman with the configured noise take out about two thirds of the noise power
+    CHECK(outputSquares < inputSquares / 3);
+}
+
+static void testChannelsAreIndependent() {
+    ReadingFilter filter;
+    SensorReading reading = makeReading(CHANNEL_TEMPERATURE, 21.0f);
+    reading.set(CHANNEL_HUMIDITY, 150.0f);
+    filter.apply(reading);
+    CHECK(reading.has(CHANNEL_TEMPERATURE));
+    CHECK(!reading.has(CHANNEL_HUMIDITY));
+    CHECK(reading.status == SENSOR_OK);
+    CHECK(filter.getRejectedCount(CHANNEL_TEMPERATURE) == 0);
+    CHECK(filter.getRejectedCount(CHANNEL_HUMIDITY) == 1);
+}
+
+static void testSyntheticOfficeTrace() {
+    // No recorded trace ships with the repository, so the realistic case is the generated office
+    // morning: slow drifts plus occupancy ramps. Nothing in it is a fault, nothing may be rejected
+    // and the filtered values have to follow within the sensors' own accuracy
+    ReadingFilter filter;
+    const char* position = SYNTHETIC_OFFICE_TRACE;
+    TraceReplayDriver::TraceRow row;
+    int rows = 0;
+    double worstTemperature = 0.0, worstHumidity = 0.0;
+    while (TraceReplayDriver::parseRow(position, row)) {
+        SensorReading reading = makeReading(CHANNEL_TEMPERATURE, row.temperature);
+        reading.set(CHANNEL_HUMIDITY, row.humidity);
+        filter.apply(reading);
+        CHECK(reading.has(CHANNEL_TEMPERATURE) && reading.has(CHANNEL_HUMIDITY));
+        worstTemperature = fmax(worstTemperature, fabs(reading.values[CHANNEL_TEMPERATURE] - row.temperature));
+        worstHumidity = fmax(worstHumidity, fabs(reading.values[CHANNEL_HUMIDITY] - row.humidity));
+        rows++;
+    }
+    printf("synthetic trace %d rows, worst lag %.3f °C, %.3f %%RH\n", rows, worstTemperature, worstHumidity);
+    CHECK(rows > 100);
+    CHECK(filter.getRejectedCount(CHANNEL_TEMPERATURE) == 0 && filter.getRejectedCount(CHANNEL_HUMIDITY) == 0);
+    CHECK(worstTemperature < 0.5);
+    CHECK(worstHumidity < 2.0);
+}
+
+int main() {
+    testConstantPassesThrough();
+    testOutOfRangeIsRejected();
+    testSingleOutlierIsDropped();
+    testPersistentJumpIsAccepted();
+    testOutOfRangeDoesNotCountTowardsJump();
+    testStepResponseSettles();
+    testMedianRemovesSpike();
+    testNoiseIsReduced();
+    testChannelsAreIndependent();
+    testSyntheticOfficeTrace();
+    return TEST_RESULT();
+}
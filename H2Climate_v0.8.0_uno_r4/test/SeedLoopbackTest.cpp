@@ -0,0 +1,157 @@
+// Two devices on the loopback network: a FirmwareSeeder serving an image and a peer
+// that downloads it the way NetworkManager does from a seed, a ranged GET that
+// resumes with "Range: bytes=N-" after the connection breaks, hashed as it arrives.
+
+#include "TestAssert.h"
+#include <vector>
+#include "../src/network/FirmwareSeeder.h"
+#include "../src/utils/Sha256.h"
+
+const int IMAGE_SIZE = 20000;
+const int POLL_LIMIT = 10000;
+
+// The downloading side of NetworkManager::pollUpdate() for a seed, without the flash
+struct SeedDownload {
+    WiFiClient client;
+    std::vector<uint8_t> image;
+    Sha256 hasher;
+    String statusLine;
+    String contentRange;
+    bool headersDone = false;
+
+    // pollUpdateConnect()
+    bool connect(bool lateRange) {
+        if (!client.connect("192.168.1.23", SEED_PORT)) {
+            return false;
+        }
+        statusLine = "";
+        contentRange = "";
+        headersDone = false;
+        client.print("GET " + String(SEED_ROUTE) + "?version=" + String(FIRMWARE_VERSION) + " HTTP/1.1\r\n" +
+                     "Host: 192.168.1.23\r\n");
+        if (!lateRange) {
+            sendRange();
+        }
+        return true;
+    }
+
+    void sendRange() {
+        client.print("Range: bytes=" + String((int)image.size()) + "-\r\nConnection: close\r\n\r\n");
+    }
+
+    // pollUpdateHeaders() and pollUpdateDownload(), false once the connection is gone
+    bool poll(int stopAt) {
+        while (!headersDone && client.available()) {
+            String line = client.readStringUntil('\n');
+            if (line.startsWith("HTTP/1.")) {
+                statusLine = line;
+            } else if (line.startsWith("Content-Range:")) {
+                contentRange = line;
+            } else if (line == "\r") {
+                headersDone = true;
+            }
+        }
+        while (headersDone && client.available() && (int)image.size() < stopAt) {
+            uint8_t value = client.read();
+            hasher.update(&value, 1);
+            image.push_back(value);
+        }
+        if ((int)image.size() >= stopAt && stopAt < IMAGE_SIZE) {
+            client.stop(); // The link breaks mid-transfer
+            return false;
+        }
+        if (!client.connected()) {
+            client.stop();
+            return false;
+        }
+        return true;
+    }
+};
+
+// Runs both devices until the peer's connection ends
+static void transfer(FirmwareSeeder& seeder, SeedDownload& peer, int stopAt) {
+    for (int i = 0; i < POLL_LIMIT; i++) {
+        seeder.poll();
+        if (!peer.poll(stopAt)) {
+            break;
+        }
+    }
+    seeder.poll(); // Lets the seeder notice the closed connection
+}
+
+static void testResumedDownload(FirmwareSeeder& seeder, const uint8_t* image, const String& sha256) {
+    SeedDownload peer;
+    CHECK(peer.connect(false));
+    transfer(seeder, peer, 7000);
+    CHECK(peer.statusLine.indexOf("206 Partial Content") > 0);
+    CHECK(peer.contentRange.indexOf("bytes 0-" + String(IMAGE_SIZE - 1) + "/" + String(IMAGE_SIZE)) > 0);
+    CHECK((int)peer.image.size() == 7000);
+
+    // Resume where it stopped, the Range header arrives in a later segment
+    CHECK(peer.connect(true));
+    seeder.poll();
+    seeder.poll();
+    peer.sendRange();
+    transfer(seeder, peer, IMAGE_SIZE);
+    CHECK(peer.statusLine.indexOf("206 Partial Content") > 0);
+    CHECK(peer.contentRange.indexOf("bytes 7000-" + String(IMAGE_SIZE - 1) + "/" + String(IMAGE_SIZE)) > 0);
+    CHECK(peer.image.size() == IMAGE_SIZE && memcmp(peer.image.data(), image, IMAGE_SIZE) == 0);
+    CHECK(peer.hasher.finishHex() == sha256);
+}
+
+static void testSlowPeer(FirmwareSeeder& seeder) {
+    // A peer that never finishes its headers must not hold up the loop
+    WiFiClient slow;
+    CHECK(slow.connect("192.168.1.23", SEED_PORT));
+    slow.print("GET " + String(SEED_ROUTE) + " HTTP/1.1\r\n");
+    unsigned long startMillis = millis();
+    for (int i = 0; i < 100; i++) {
+        seeder.poll();
+    }
+    CHECK(millis() == startMillis);
+    CHECK(slow.available() == 0);
+
+    hostAdvanceMillis(SEED_REQUEST_TIMEOUT);
+    seeder.poll();
+    CHECK(slow.readStringUntil('\n').startsWith("HTTP/1.1 408"));
+    slow.stop();
+    seeder.poll();
+}
+
+static void testParkedRadio(FirmwareSeeder& seeder, const uint8_t* image, const String& sha256) {
+    // WiFi.end() on park drops the listening socket, peers cannot connect meanwhile
+    hostSetWiFiStatus(WL_DISCONNECTED);
+    hostAdvanceMillis(SEED_LINK_CHECK_INTERVAL);
+    seeder.poll();
+    SeedDownload parked;
+    CHECK(!parked.connect(false));
+
+    // Back up, the seeder listens again on its next link check
+    hostSetWiFiStatus(WL_CONNECTED);
+    hostAdvanceMillis(SEED_LINK_CHECK_INTERVAL);
+    seeder.poll();
+    testResumedDownload(seeder, image, sha256);
+}
+
+int main() {
+    std::vector<uint8_t> image(IMAGE_SIZE);
+    uint32_t state = 12345;
+    for (uint8_t& value : image) {
+        state = state * 1103515245 + 12345;
+        value = state >> 16;
+    }
+    Sha256 hasher;
+    hasher.update(image.data(), image.size());
+    String sha256 = hasher.finishHex();
+
+    hostSetMillis(0);
+    FancyLog fancyLog;
+    FirmwareSeeder seeder(fancyLog);
+    seeder.serve(image.data(), IMAGE_SIZE);
+    seeder.poll();
+
+    testResumedDownload(seeder, image.data(), sha256);
+    testSlowPeer(seeder);
+    testParkedRadio(seeder, image.data(), sha256);
+    return TEST_RESULT();
+}
@@ -0,0 +1,99 @@
+#include "TestAssert.h"
+#include "../src/network/SeedRequest.h"
+
+const int IMAGE_SIZE = 180000;
+
+// Feeds complete lines as they arrive, like the seeder does between TCP segments
+static void deliver(SeedRequest& request, const String& segment) {
+    int start = 0;
+    while (start < (int)segment.length()) {
+        int end = segment.indexOf('\n', start);
+        request.addLine(segment.substring(start, end));
+        start = end + 1;
+    }
+}
+
+static String peerRequest(const String& rangeHeader) {
+    // Same request the downloading peer builds in NetworkManager::pollUpdateConnect()
+    return "GET " + String(SEED_ROUTE) + "?version=" + String(FIRMWARE_VERSION) + " HTTP/1.1\r\n" +
+           "Host: 192.168.1.23\r\n" + rangeHeader + "Connection: close\r\n\r\n";
+}
+
+static void testLateRangeHeader() {
+    // The Range header arrives in a second segment after a pause
+    SeedRequest request(IMAGE_SIZE);
+    deliver(request, "GET " + String(SEED_ROUTE) + "?version=" + String(FIRMWARE_VERSION) + " HTTP/1.1\r\nHost: 192.168.1.23\r\n");
+    CHECK(!request.isComplete());
+    deliver(request, "Range: bytes=4096-\r\nConnection: close\r\n\r\n");
+    CHECK(request.isComplete());
+    CHECK(request.getStatus() == 206);
+    CHECK(request.getRangeStart() == 4096);
+    CHECK(request.getRangeEnd() == IMAGE_SIZE - 1);
+
+    // What the downloading peer checks in pollUpdateHeaders()
+    String header = request.getResponseHeader();
+    CHECK(header.indexOf("206 Partial Content") > 0);
+    CHECK(header.indexOf("Content-Length: " + String(IMAGE_SIZE - 4096) + "\r\n") > 0);
+    CHECK(header.indexOf("Content-Range: bytes 4096-" + String(IMAGE_SIZE - 1) + "/" + String(IMAGE_SIZE)) > 0);
+}
+
+static void testRanges() {
+    SeedRequest full(IMAGE_SIZE);
+    deliver(full, peerRequest(""));
+    CHECK(full.getStatus() == 200);
+    CHECK(full.getResponseHeader().indexOf("Content-Length: " + String(IMAGE_SIZE) + "\r\n") > 0);
+
+    SeedRequest closed(IMAGE_SIZE);
+    deliver(closed, peerRequest("range: bytes=100-199\r\n")); // Header names are case-insensitive
+    CHECK(closed.getStatus() == 206);
+    CHECK(closed.getRangeStart() == 100 && closed.getRangeEnd() == 199);
+
+    SeedRequest suffix(IMAGE_SIZE);
+    deliver(suffix, peerRequest("Range: bytes=-500\r\n"));
+    CHECK(suffix.getStatus() == 206);
+    CHECK(suffix.getRangeStart() == IMAGE_SIZE - 500 && suffix.getRangeEnd() == IMAGE_SIZE - 1);
+
+    SeedRequest clipped(IMAGE_SIZE);
+    deliver(clipped, peerRequest("Range: bytes=1000-999999\r\n"));
+    CHECK(clipped.getRangeEnd() == IMAGE_SIZE - 1);
+
+    SeedRequest pastEnd(IMAGE_SIZE);
+    deliver(pastEnd, peerRequest("Range: bytes=" + String(IMAGE_SIZE) + "-\r\n"));
+    CHECK(pastEnd.getStatus() == 416);
+    CHECK(pastEnd.getResponseHeader().startsWith("HTTP/1.1 416"));
+
+    SeedRequest units(IMAGE_SIZE);
+    deliver(units, peerRequest("Range: items=0-10\r\n"));
+    CHECK(units.getStatus() == 416);
+}
+
+static void testWrongRequest() {
+    SeedRequest version(IMAGE_SIZE);
+    deliver(version, "GET " + String(SEED_ROUTE) + "?version=V0.0.1 HTTP/1.1\r\n\r\n");
+    CHECK(version.getStatus() == 404);
+
+    // A longer version that starts with ours is a different build
+    SeedRequest longer(IMAGE_SIZE);
+    deliver(longer, "GET " + String(SEED_ROUTE) + "?version=" + String(FIRMWARE_VERSION) + "1 HTTP/1.1\r\n\r\n");
+    CHECK(longer.getStatus() == 404);
+
+    SeedRequest prefix(IMAGE_SIZE);
+    deliver(prefix, "GET " + String(SEED_ROUTE) + "?version=" + String(FIRMWARE_VERSION) + "1&x=1 HTTP/1.1\r\n\r\n");
+    CHECK(prefix.getStatus() == 404);
+
+    SeedRequest parameters(IMAGE_SIZE);
+    deliver(parameters, "GET " + String(SEED_ROUTE) + "?version=" + String(FIRMWARE_VERSION) + "&x=1 HTTP/1.1\r\n\r\n");
+    CHECK(parameters.getStatus() == 200);
+
+    SeedRequest path(IMAGE_SIZE);
+    deliver(path, "GET /other HTTP/1.1\r\nRange: bytes=0-\r\n\r\n");
+    CHECK(path.getStatus() == 404);
+    CHECK(path.getResponseHeader().startsWith("HTTP/1.1 404"));
+}
+
+int main() {
+    testLateRangeHeader();
+    testRanges();
+    testWrongRequest();
+    return TEST_RESULT();
+}
@@ -0,0 +1,32 @@
+#ifndef TEST_ASSERT_H
+#define TEST_ASSERT_H
+
+// Minimal assertions for the host tests, each test binary returns the number of failures
+
+#include <stdio.h>
+#include <math.h>
+
+static int testFailures = 0;
+
+#define CHECK(condition)                                                                    \
+    do {                                                                                    \
+        if (!(condition)) {                                                                 \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);           \
+            testFailures++;                                                                 \
+        }                                                                                   \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                             \
+    do {                                                                                    \
+        double actualValue = (actual), expectedValue = (expected);                          \
+        if (!(fabs(actualValue - expectedValue) <= (tolerance))) {                          \
+            printf("%s:%d: %s = %g, expected %g +- %g\n", __FILE__, __LINE__, #actual,      \
+                   actualValue, expectedValue, (double)(tolerance));                        \
+            testFailures++;                                                                 \
+        }                                                                                   \
+    } while (0)
+
+#define TEST_RESULT()                                                                       \
+    (printf(testFailures == 0 ? "passed\n" : "%d failure(s)\n", testFailures), testFailures)
+
+#endif // TEST_ASSERT_H
@@ -0,0 +1,135 @@
+#include "TestAssert.h"
+#include "../src/network/UpdateScheduler.h"
+
+const int FLEET_SIZE = 1000;
+
+static String fleetDeviceId(int index) {
+    // Consecutive MAC addresses from one production batch, the worst case for the hash
+    char id[13];
+    snprintf(id, sizeof(id), "f412fa%06x", 0x4a1000 + index);
+    return String(id);
+}
+
+// Largest number of devices that check within one bucket of the given width
+static int peakLoad(const unsigned long* offsets, int count, unsigned long span, unsigned long bucket) {
+    static int buckets[1024];
+    int bucketCount = span / bucket + 1;
+    for (int i = 0; i < bucketCount; i++) {
+        buckets[i] = 0;
+    }
+    int peak = 0;
+    for (int i = 0; i < count; i++) {
+        int index = min((int)(offsets[i] / bucket), bucketCount - 1);
+        peak = max(peak, ++buckets[index]);
+    }
+    return peak;
+}
+
+static void testParseHttpDate() {
+    CHECK(parseHttpDate(" Sun, 18 Oct 2026 21:19:25 GMT\r") == 1792358365);
+    CHECK(parseHttpDate("Thu, 29 Feb 2024 12:00:00 GMT") == 1709208000);
+    CHECK(parseHttpDate("Thu, 01 Jan 2026 00:00:00 GMT") == 1767225600);
+    CHECK(parseHttpDate("") == 0);
+    CHECK(parseHttpDate("Sun, 18 Foo 2026 21:19:25 GMT") == 0);
+    CHECK(parseHttpDate("Thu, 01 Jan 1970 00:00:10 GMT") == 0); // Not a real clock
+}
+
+static void testFleetSpread() {
+    static UpdateScheduler fleet[FLEET_SIZE];
+    static unsigned long offsets[FLEET_SIZE];
+
+    // The whole fleet powers up in the same second after an outage
+    for (int i = 0; i < FLEET_SIZE; i++) {
+        fleet[i].begin(fleetDeviceId(i), 0);
+        offsets[i] = fleet[i].getMillisUntilDue(0);
+        CHECK(offsets[i] < UPDATE_CHECK_BOOT_SPREAD);
+    }
+    unsigned long bucket = 10000;
+    double expected = (double)FLEET_SIZE * bucket / UPDATE_CHECK_BOOT_SPREAD;
+    int bootPeak = peakLoad(offsets, FLEET_SIZE, UPDATE_CHECK_BOOT_SPREAD, bucket);
+    printf("Boot: peak %d checks per %lu s, %.1f when uniform\n", bootPeak, bucket / 1000, expected);
+    CHECK(bootPeak < 2.0 * expected);
+
+    // Each device checks when due, and the next check stays out of phase
+    for (int i = 0; i < FLEET_SIZE; i++) {
+        CHECK(!fleet[i].isDue(offsets[i] - 1, 0));
+        CHECK(fleet[i].isDue(offsets[i], 0));
+        fleet[i].onCheckCompleted(offsets[i], 0);
+        unsigned long next = fleet[i].getMillisUntilDue(offsets[i]);
+        CHECK(next >= CHECK_INTERVAL && next < CHECK_INTERVAL + UPDATE_CHECK_JITTER);
+        offsets[i] += next - CHECK_INTERVAL;
+    }
+    // Boot offset plus jitter is no longer uniform, its density peaks at that of the wider one
+    unsigned long span = UPDATE_CHECK_BOOT_SPREAD + UPDATE_CHECK_JITTER;
+    expected = (double)FLEET_SIZE * bucket / max(UPDATE_CHECK_BOOT_SPREAD, UPDATE_CHECK_JITTER);
+    int intervalPeak = peakLoad(offsets, FLEET_SIZE, span, bucket);
+    printf("Hourly: peak %d checks per %lu s, %.1f at the ideal peak\n", intervalPeak, bucket / 1000, expected);
+    CHECK(intervalPeak < 2.0 * expected);
+
+    // A busy server answers everyone with the same Retry-After, the jitter keeps them apart
+    unsigned long hintSeconds = 600;
+    for (int i = 0; i < FLEET_SIZE; i++) {
+        fleet[i].onCheckCompleted(0, hintSeconds);
+        unsigned long next = fleet[i].getMillisUntilDue(0);
+        CHECK(next >= hintSeconds * 1000UL && next <= hintSeconds * 1100UL);
+        offsets[i] = next - hintSeconds * 1000UL;
+    }
+    bucket = 1000;
+    expected = (double)FLEET_SIZE * bucket / (hintSeconds * 100UL);
+    int hintPeak = peakLoad(offsets, FLEET_SIZE, hintSeconds * 100UL, bucket);
+    printf("Retry-After %lu s: peak %d checks per %lu s, %.1f when uniform\n", hintSeconds, hintPeak, bucket / 1000, expected);
+    CHECK(hintPeak < 2.0 * expected);
+}
+
+const time_t MIDNIGHT = 1767225600; // 2026-01-01 00:00 UTC
+
+// Checks at `hourOfDay` with the given window: due right away, or postponed into the window
+static void checkWindowAt(int start, int end, double hourOfDay, bool inside) {
+    UpdateScheduler scheduler(start, end);
+    scheduler.begin(fleetDeviceId(0), 0);
+    unsigned long due = scheduler.getMillisUntilDue(0);
+    time_t wallClock = MIDNIGHT + (time_t)(hourOfDay * 3600);
+    CHECK(scheduler.isDue(due, wallClock) == inside);
+    if (inside) {
+        return;
+    }
+
+    // Postponed to the window start plus the device offset, and due once there
+    unsigned long wait = scheduler.getMillisUntilDue(due);
+    time_t opens = wallClock + wait / 1000;
+    CHECK(hour(opens) == start);
+    CHECK(opens > wallClock && opens - wallClock <= 86400 + UPDATE_CHECK_BOOT_SPREAD / 1000);
+    CHECK(scheduler.isDue(due + wait, opens));
+}
+
+static void testMaintenanceWindow() {
+    // Until the clock is set the window cannot be known, the check goes ahead
+    UpdateScheduler unset(2, 4);
+    unset.begin(fleetDeviceId(0), 0);
+    CHECK(unset.isDue(unset.getMillisUntilDue(0), 3600));
+
+    // Equal hours, like the Config.h default, disable the window
+    checkWindowAt(0, 0, 12.0, true);
+
+    // Same-day window 02-04
+    checkWindowAt(2, 4, 3.0, true);
+    checkWindowAt(2, 4, 2.0, true);
+    checkWindowAt(2, 4, 4.0, false); // The end hour is outside
+    checkWindowAt(2, 4, 12.0, false);
+    checkWindowAt(2, 4, 1.5, false); // Opens later the same day
+
+    // Window that wraps past midnight, 22-04
+    checkWindowAt(22, 4, 23.5, true);
+    checkWindowAt(22, 4, 0.5, true);
+    checkWindowAt(22, 4, 3.9, true);
+    checkWindowAt(22, 4, 4.5, false);
+    checkWindowAt(22, 4, 12.0, false);
+    checkWindowAt(22, 4, 21.9, false);
+}
+
+int main() {
+    testParseHttpDate();
+    testFleetSpread();
+    testMaintenanceWindow();
+    return TEST_RESULT();
+}
@@ -0,0 +1,128 @@
+#include "TestAssert.h"
+#include "../src/sensors/WindowAggregator.h"
+
+static SensorReading makeReading() {
+    SensorReading reading;
+    reading.channelMask = 0;
+    reading.status = SENSOR_OK;
+    return reading;
+}
+
+//¤=======================================================================================¤
+
+static void testStatisticsMatchTwoPass() {
+    hostSetMillis(0);
+    WindowAggregator aggregator;
+    const int count = 360;
+    float values[count];
+    srand(7);
+    for (int i = 0; i < count; i++) {
+        values[i] = 21.0f + (rand() % 1000) / 250.0f;
+        SensorReading reading = makeReading();
+        reading.set(CHANNEL_TEMPERATURE, values[i]);
+        aggregator.add(reading, 1000 + i, millis());
+    }
+
+    // Reference in double precision with two passes
+    double sum = 0.0, minimum = values[0], maximum = values[0];
+    for (int i = 0; i < count; i++) {
+        sum += values[i];
+        minimum = values[i] < minimum ? values[i] : minimum;
+        maximum = values[i] > maximum ? values[i] : maximum;
+    }
+    double mean = sum / count, squares = 0.0;
+    for (int i = 0; i < count; i++) {
+        squares += (values[i] - mean) * (values[i] - mean);
+    }
+    double stddev = sqrt(squares / (count - 1));
+
+    WindowSummary summary;
+    aggregator.takeSummary(summary);
+    const ChannelSummary& stats = summary.channels[CHANNEL_TEMPERATURE];
+    CHECK(summary.channelMask == (1 << CHANNEL_TEMPERATURE));
+    CHECK(stats.count == count);
+    CHECK_NEAR(stats.min, minimum, 1e-6);
+    CHECK_NEAR(stats.max, maximum, 1e-6);
+    CHECK_NEAR(stats.mean, mean, 1e-4);
+    CHECK_NEAR(stats.stddev, stddev, 1e-4);
+    CHECK(summary.startTimestamp == 1000);
+    CHECK(summary.endTimestamp == 1000 + count - 1);
+}
+
+static void testLargeOffsetKeepsVariance() {
+    // A naive sum of squares in float loses the small spread on a large level
+    hostSetMillis(0);
+    WindowAggregator aggregator;
+    for (int i = 0; i < 100; i++) {
+        SensorReading reading = makeReading();
+        reading.set(CHANNEL_PRESSURE, 101325.0f + (i % 2 == 0 ? 0.5f : -0.5f));
+        aggregator.add(reading, i, millis());
+    }
+    WindowSummary summary;
+    aggregator.takeSummary(summary);
+    CHECK_NEAR(summary.channels[CHANNEL_PRESSURE].mean, 101325.0, 0.01);
+    CHECK_NEAR(summary.channels[CHANNEL_PRESSURE].stddev, 0.5025, 0.01);
+}
+
+static void testSoundIsEnergyAveraged() {
+    hostSetMillis(0);
+    WindowAggregator aggregator;
+    float levels[] = { 60.0f, 70.0f };
+    for (float level : levels) {
+        SensorReading reading = makeReading();
+        reading.set(CHANNEL_SOUND_LEVEL, level);
+        aggregator.add(reading, 0, millis());
+    }
+    WindowSummary summary;
+    aggregator.takeSummary(summary);
+    CHECK_NEAR(summary.channels[CHANNEL_SOUND_LEVEL].mean, 10.0 * log10((1e6 + 1e7) / 2), 0.01);
+    CHECK_NEAR(summary.channels[CHANNEL_SOUND_LEVEL].min, 60.0, 1e-6);
+}
+
+static void testMissingChannelsAndSingleSample() {
+    hostSetMillis(0);
+    WindowAggregator aggregator;
+    SensorReading reading = makeReading();
+    reading.set(CHANNEL_HUMIDITY, 45.0f);
+    aggregator.add(reading, 0, millis());
+    WindowSummary summary;
+    aggregator.takeSummary(summary);
+    CHECK(summary.channelMask == (1 << CHANNEL_HUMIDITY));
+    CHECK(summary.channels[CHANNEL_TEMPERATURE].count == 0);
+    CHECK_NEAR(summary.channels[CHANNEL_HUMIDITY].stddev, 0.0, 1e-9);
+
+    // Taking a summary starts a fresh window
+    aggregator.takeSummary(summary);
+    CHECK(summary.channelMask == 0);
+}
+
+static void testWindowTiming() {
+    hostSetMillis(5000);
+    WindowAggregator aggregator;
+    CHECK(!aggregator.isWindowDue(millis()));
+    CHECK(aggregator.getMillisUntilDue(millis()) == AGGREGATION_WINDOW);
+
+    SensorReading reading = makeReading();
+    reading.set(CHANNEL_TEMPERATURE, 21.0f);
+    aggregator.add(reading, 0, millis());
+    hostAdvanceMillis(AGGREGATION_WINDOW - 1);
+    CHECK(!aggregator.isWindowDue(millis()));
+    CHECK(aggregator.getMillisUntilDue(millis()) == 1);
+    hostAdvanceMillis(1);
+    CHECK(aggregator.isWindowDue(millis()));
+    CHECK(aggregator.getMillisUntilDue(millis()) == 0);
+
+    // A longer window applies to the running one
+    aggregator.setWindowLength(2 * AGGREGATION_WINDOW);
+    CHECK(!aggregator.isWindowDue(millis()));
+    CHECK(aggregator.getMillisUntilDue(millis()) == AGGREGATION_WINDOW);
+}
+
+int main() {
+    testStatisticsMatchTwoPass();
+    testLargeOffsetKeepsVariance();
+    testSoundIsEnergyAveraged();
+    testMissingChannelsAndSingleSample();
+    testWindowTiming();
+    return TEST_RESULT();
+}
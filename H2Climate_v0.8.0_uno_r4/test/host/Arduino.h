@@ -0,0 +1,112 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Host stand-in for the Arduino core, just enough for the hardware-free kernels.
+// Time comes from a virtual clock the tests and the replay tool move forward.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+#include <string>
+
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define FALLING 2
+#define A0 14
+#define A1 15
+#define PI 3.14159265358979f
+
+class String {
+  public:
+    String() {}
+    String(const char* text) : text(text ? text : "") {}
+    String(const std::string& text) : text(text) {}
+    String(char c) : text(1, c) {}
+    String(int value) : text(std::to_string(value)) {}
+    String(unsigned int value) : text(std::to_string(value)) {}
+    String(long value) : text(std::to_string(value)) {}
+    String(unsigned long value) : text(std::to_string(value)) {}
+    String(double value, int decimals = 2) {
+        char buffer[48];
+        snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+        text = buffer;
+    }
+    unsigned int length() const { return text.size(); }
+    const char* c_str() const { return text.c_str(); }
+    char operator[](unsigned int index) const { return index < text.size() ? text[index] : 0; }
+    char charAt(unsigned int index) const { return (*this)[index]; }
+    int indexOf(char c, unsigned int from = 0) const { return position(text.find(c, from)); }
+    int indexOf(const String& part, unsigned int from = 0) const { return position(text.find(part.text, from)); }
+    String substring(unsigned int from) const { return from < text.size() ? String(text.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const { return from < text.size() && to > from ? String(text.substr(from, to - from)) : String(); }
+    bool startsWith(const String& prefix) const { return text.compare(0, prefix.text.size(), prefix.text) == 0; }
+    bool equalsIgnoreCase(const String& other) const { String a(*this), b(other); a.toLowerCase(); b.toLowerCase(); return a == b; }
+    long toInt() const { return atol(text.c_str()); }
+    float toFloat() const { return atof(text.c_str()); }
+    void toCharArray(char* buffer, unsigned int size) const {
+        if (size > 0) {
+            snprintf(buffer, size, "%s", text.c_str());
+        }
+    }
+    void toLowerCase() { for (char& c : text) c = tolower((unsigned char)c); }
+    void trim() {
+        size_t first = text.find_first_not_of(" \t\r\n");
+        size_t last = text.find_last_not_of(" \t\r\n");
+        text = first == std::string::npos ? "" : text.substr(first, last - first + 1);
+    }
+    String& operator+=(const String& other) { text += other.text; return *this; }
+    String& operator+=(char c) { text += c; return *this; }
+    bool operator==(const String& other) const { return text == other.text; }
+    bool operator!=(const String& other) const { return text != other.text; }
+    friend String operator+(const String& a, const String& b) { return String(a.text + b.text); }
+
+  private:
+    std::string text;
+    static int position(size_t found) { return found == std::string::npos ? -1 : (int)found; }
+};
+
+// Serial goes to stdout, so ctest shows the firmware log of a failing test
+class HostSerial {
+  public:
+    void begin(unsigned long) {}
+    void print(const String& text) { fputs(text.c_str(), stdout); }
+    void println(const String& text = String()) { puts(text.c_str()); }
+    operator bool() const { return true; }
+};
+extern HostSerial Serial;
+
+// Virtual clock, starts at zero
+unsigned long millis();
+unsigned long micros();
+void hostSetMillis(unsigned long value);
+void hostAdvanceMillis(unsigned long delta);
+
+// The ADC returns whatever the test put there
+int analogRead(int pin);
+void hostSetAnalogValue(int value);
+
+inline void delay(unsigned long duration) { hostAdvanceMillis(duration); }
+inline void delayMicroseconds(unsigned int) {}
+inline void analogReadResolution(int) {}
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int digitalRead(int) { return LOW; }
+inline void noInterrupts() {}
+inline void interrupts() {}
+inline void yield() {}
+
+#define constrain(amount, low, high) ((amount) < (low) ? (low) : ((amount) > (high) ? (high) : (amount)))
+template <class T, class L> auto min(const T& a, const L& b) -> decltype((b < a) ? b : a) { return (b < a) ? b : a; }
+template <class T, class L> auto max(const T& a, const L& b) -> decltype((b < a) ? b : a) { return (a < b) ? b : a; }
+
+#define __WFI()
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,93 @@
+#ifndef HOST_ARDUINO_JSON_H
+#define HOST_ARDUINO_JSON_H
+
+// Host stand-in for the part of ArduinoJson 6 the kernels use: nested objects,
+// scalar members and serializeJson(). Enough to assert on the payload text.
+
+#include <memory>
+#include <utility>
+#include <vector>
+#include "Arduino.h"
+
+class JsonVariant {
+  public:
+    JsonVariant() {}
+    JsonVariant operator[](const char* key) const;
+    bool isNull() const { return !node || (!node->object && node->scalar.empty()); }
+    JsonVariant& operator=(const char* value) { return assign("\"" + std::string(value) + "\""); }
+    JsonVariant& operator=(const String& value) { return *this = value.c_str(); }
+    JsonVariant& operator=(bool value) { return assign(value ? "true" : "false"); }
+    JsonVariant& operator=(int value) { return assign(std::to_string(value)); }
+    JsonVariant& operator=(unsigned int value) { return assign(std::to_string(value)); }
+    JsonVariant& operator=(long value) { return assign(std::to_string(value)); }
+    JsonVariant& operator=(unsigned long value) { return assign(std::to_string(value)); }
+    JsonVariant& operator=(double value) { return assign(String(value, 6).c_str()); }
+    void serialize(std::string& out) const;
+
+  protected:
+    struct Node {
+      bool object = false;
+      std::string scalar; // Already JSON encoded
+      std::vector<std::pair<std::string, std::shared_ptr<Node>>> members;
+    };
+    std::shared_ptr<Node> node;
+    explicit JsonVariant(std::shared_ptr<Node> node) : node(node) {}
+    JsonVariant& assign(const std::string& encoded) { node->object = false; node->scalar = encoded; return *this; }
+    std::shared_ptr<Node> member(const char* key) const;
+};
+
+class JsonObject : public JsonVariant {
+  public:
+    JsonObject() {}
+    JsonObject createNestedObject(const char* key) const {
+        std::shared_ptr<Node> child = member(key);
+        child->object = true;
+        return JsonObject(child);
+    }
+
+  protected:
+    explicit JsonObject(std::shared_ptr<Node> node) : JsonVariant(node) {}
+};
+
+class JsonDocument : public JsonObject {
+  public:
+    JsonDocument() : JsonObject(std::make_shared<Node>()) { node->object = true; }
+    bool overflowed() const { return false; }
+};
+
+template <size_t capacity> class StaticJsonDocument : public JsonDocument {};
+
+inline std::shared_ptr<JsonVariant::Node> JsonVariant::member(const char* key) const {
+    for (auto& entry : node->members) {
+        if (entry.first == key) {
+            return entry.second;
+        }
+    }
+    node->object = true;
+    node->members.push_back(std::make_pair(std::string(key), std::make_shared<Node>()));
+    return node->members.back().second;
+}
+
+inline JsonVariant JsonVariant::operator[](const char* key) const { return JsonVariant(member(key)); }
+
+inline void JsonVariant::serialize(std::string& out) const {
+    if (!node->object) {
+        out += node->scalar.empty() ? "null" : node->scalar;
+        return;
+    }
+    out += "{";
+    for (size_t i = 0; i < node->members.size(); i++) {
+        out += (i > 0 ? ",\"" : "\"") + node->members[i].first + "\":";
+        JsonVariant(node->members[i].second).serialize(out);
+    }
+    out += "}";
+}
+
+inline size_t serializeJson(const JsonDocument& doc, String& output) {
+    std::string out;
+    doc.serialize(out);
+    output = String(out);
+    return out.size();
+}
+
+#endif // HOST_ARDUINO_JSON_H
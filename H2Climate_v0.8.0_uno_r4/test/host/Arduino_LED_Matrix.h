@@ -0,0 +1 @@
+// Host build: the kernels under test do not use Arduino_LED_Matrix
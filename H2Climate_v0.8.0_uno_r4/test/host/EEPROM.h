@@ -0,0 +1,27 @@
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+// Host build: EEPROM is a zeroed byte array that lives as long as the test process
+
+#include <string.h>
+
+class HostEEPROM {
+  public:
+    template <class T> T& get(int address, T& value) {
+        memcpy(&value, bytes + address, sizeof(T));
+        return value;
+    }
+    template <class T> const T& put(int address, const T& value) {
+        memcpy(bytes + address, &value, sizeof(T));
+        return value;
+    }
+    uint8_t read(int address) { return bytes[address]; }
+    void write(int address, uint8_t value) { bytes[address] = value; }
+    int length() { return sizeof(bytes); }
+
+  private:
+    uint8_t bytes[8192] = {};
+};
+extern HostEEPROM EEPROM;
+
+#endif // HOST_EEPROM_H
@@ -0,0 +1,26 @@
+#include "Arduino.h"
+
+HostSerial Serial;
+
+static unsigned long virtualMillis = 0;
+static int analogValue = 0;
+
+unsigned long millis() { return virtualMillis; }
+unsigned long micros() { return virtualMillis * 1000UL; }
+void hostSetMillis(unsigned long value) { virtualMillis = value; }
+void hostAdvanceMillis(unsigned long delta) { virtualMillis += delta; }
+
+int analogRead(int) { return analogValue; }
+void hostSetAnalogValue(int value) { analogValue = value; }
+
+#include "TimeLib.h"
+
+static time_t epochBase = 0;
+static unsigned long epochSetMillis = 0;
+
+void setTime(time_t t) {
+    epochBase = t;
+    epochSetMillis = virtualMillis;
+}
+
+time_t now() { return epochBase + (virtualMillis - epochSetMillis) / 1000; }
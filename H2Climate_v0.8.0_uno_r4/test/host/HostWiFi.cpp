@@ -0,0 +1,111 @@
+#include "WiFiS3.h"
+#include "EEPROM.h"
+#include <map>
+
+WiFiClass WiFi;
+HostEEPROM EEPROM;
+
+// Connections waiting to be accepted, per listening port
+static std::map<int, std::deque<std::shared_ptr<HostConnection>>> listeners;
+
+void hostSetWiFiStatus(int status) {
+    WiFi.linkStatus = status;
+    if (status != WL_CONNECTED) {
+        listeners.clear();
+    }
+}
+
+//¤=======================================================================================¤
+
+int WiFiClient::connect(const char*, uint16_t port) {
+    auto listener = listeners.find(port);
+    if (WiFi.status() != WL_CONNECTED || listener == listeners.end()) {
+        return 0;
+    }
+    connection = std::make_shared<HostConnection>();
+    serverSide = false;
+    listener->second.push_back(connection);
+    return 1;
+}
+
+uint8_t WiFiClient::connected() {
+    if (!connection) {
+        return 0;
+    }
+    // Like TCP, what the other side sent before closing can still be read
+    return (connection->clientOpen && connection->serverOpen) || available() > 0;
+}
+
+int WiFiClient::available() {
+    return connection ? (int)incoming().size() : 0;
+}
+
+int WiFiClient::read() {
+    if (available() == 0) {
+        return -1;
+    }
+    uint8_t value = incoming().front();
+    incoming().pop_front();
+    return value;
+}
+
+int WiFiClient::read(uint8_t* buffer, size_t size) {
+    int count = 0;
+    while (count < (int)size && available() > 0) {
+        buffer[count++] = read();
+    }
+    return count;
+}
+
+size_t WiFiClient::write(const uint8_t* data, size_t size) {
+    if (!connection || !connection->clientOpen || !connection->serverOpen) {
+        return 0;
+    }
+    std::deque<uint8_t>& outgoing = serverSide ? connection->toClient : connection->toServer;
+    outgoing.insert(outgoing.end(), data, data + size);
+    return size;
+}
+
+size_t WiFiClient::print(const String& text) {
+    return write(reinterpret_cast<const uint8_t*>(text.c_str()), text.length());
+}
+
+String WiFiClient::readStringUntil(char terminator) {
+    String line;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) {
+        line += (char)c;
+    }
+    return line;
+}
+
+void WiFiClient::stop() {
+    if (connection) {
+        (serverSide ? connection->serverOpen : connection->clientOpen) = false;
+        connection.reset();
+    }
+}
+
+//¤=======================================================================================¤
+
+void WiFiServer::begin() {
+    if (WiFi.status() == WL_CONNECTED) {
+        listeners[port];
+    }
+}
+
+void WiFiServer::end() {
+    listeners.erase(port);
+}
+
+WiFiClient WiFiServer::available() {
+    WiFiClient client;
+    auto listener = listeners.find(port);
+    if (listener == listeners.end() || listener->second.empty()) {
+        return client;
+    }
+    client.connection = listener->second.front();
+    client.serverSide = true;
+    listener->second.pop_front();
+    return client;
+}
@@ -0,0 +1,11 @@
+#ifndef HOST_TIMELIB_H
+#define HOST_TIMELIB_H
+
+#include <time.h>
+
+// Wall clock follows the virtual millis() from the epoch set last
+void setTime(time_t t);
+time_t now();
+inline int hour(time_t t) { return (int)((t % 86400) / 3600); }
+
+#endif // HOST_TIMELIB_H
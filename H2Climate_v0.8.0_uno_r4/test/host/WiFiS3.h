@@ -0,0 +1,72 @@
+#ifndef HOST_WIFIS3_H
+#define HOST_WIFIS3_H
+
+// Host build: an in-memory loopback network. A WiFiClient that connects to a port
+// reaches the WiFiServer listening on it, whatever the host, so two devices can
+// talk inside one test process. Nothing blocks, bytes are there as soon as written.
+
+#include "Arduino.h"
+#include <deque>
+#include <memory>
+
+#define WL_IDLE_STATUS 0
+#define WL_CONNECTED 3
+#define WL_DISCONNECTED 6
+
+// Both directions of one TCP connection
+struct HostConnection {
+    std::deque<uint8_t> toServer;
+    std::deque<uint8_t> toClient;
+    bool clientOpen = true;
+    bool serverOpen = true;
+};
+
+class WiFiClient {
+  public:
+    int connect(const char* host, uint16_t port);
+    uint8_t connected();
+    int available();
+    int read();
+    int read(uint8_t* buffer, size_t size);
+    size_t write(const uint8_t* data, size_t size);
+    size_t print(const String& text);
+    String readStringUntil(char terminator);
+    void setTimeout(unsigned long) {}
+    void stop();
+    operator bool() const { return connection != nullptr; }
+
+  private:
+    friend class WiFiServer;
+    std::shared_ptr<HostConnection> connection;
+    bool serverSide = false;
+    std::deque<uint8_t>& incoming() { return serverSide ? connection->toServer : connection->toClient; }
+};
+
+class WiFiServer {
+  public:
+    WiFiServer(int port) : port(port) {}
+    void begin();
+    void end();
+    WiFiClient available(); // Next connection that was not handed out yet
+
+  private:
+    int port;
+};
+
+// Only the link state, the tests park and restore the radio through it
+class WiFiClass {
+  public:
+    int status() { return linkStatus; }
+    void end() { linkStatus = WL_DISCONNECTED; }
+    void setTimeout(unsigned long) {}
+
+  private:
+    friend void hostSetWiFiStatus(int status);
+    int linkStatus = WL_CONNECTED;
+};
+extern WiFiClass WiFi;
+
+// Also ends every listening server, like WiFi.end() does on the module
+void hostSetWiFiStatus(int status);
+
+#endif // HOST_WIFIS3_H